@@ -22,6 +22,7 @@
 #include "gdkinternals.h"
 
 #include <math.h>
+#include <string.h>
 
 /**
  * SECTION:cairo_interaction
@@ -210,53 +211,55 @@ gdk_cairo_surface_paint_pixbuf (cairo_surface_t *surface,
   for (j = height; j; j--)
     {
       guchar *p = gdk_pixels;
-      guchar *q = cairo_pixels;
+      guint32 *q = (guint32 *) cairo_pixels;
+      guint32 *end = q + width;
 
       if (n_channels == 3)
         {
-          guchar *end = p + 3 * width;
-
-          while (p < end)
+          while (q < end)
             {
-#if G_BYTE_ORDER == G_LITTLE_ENDIAN
-              q[0] = p[2];
-              q[1] = p[1];
-              q[2] = p[0];
-#else
-              q[1] = p[0];
-              q[2] = p[1];
-              q[3] = p[2];
-#endif
+              *q = 0xff000000 | (p[0] << 16) | (p[1] << 8) | p[2];
               p += 3;
-              q += 4;
+              q++;
             }
         }
       else
         {
-          guchar *end = p + 4 * width;
-          guint t1,t2,t3;
-
-#define MULT(d,c,a,t) G_STMT_START { t = c * a + 0x80; d = ((t >> 8) + t) >> 8; } G_STMT_END
-
-          while (p < end)
+          while (q < end)
             {
-#if G_BYTE_ORDER == G_LITTLE_ENDIAN
-              MULT(q[0], p[2], p[3], t1);
-              MULT(q[1], p[1], p[3], t2);
-              MULT(q[2], p[0], p[3], t3);
-              q[3] = p[3];
-#else
-              q[0] = p[3];
-              MULT(q[1], p[0], p[3], t1);
-              MULT(q[2], p[1], p[3], t2);
-              MULT(q[3], p[2], p[3], t3);
-#endif
+              guint32 s, a;
+
+              /* Load the pixel as 0xAABBGGRR whatever the byte order */
+              memcpy (&s, p, 4);
+              s = GUINT32_FROM_LE (s);
+              a = s >> 24;
+
+              if (a == 0xff)
+                {
+                  /* Opaque, only swap red and blue */
+                  *q = (s & 0xff00ff00) | ((s & 0xff) << 16) | ((s >> 16) & 0xff);
+                }
+              else if (a == 0)
+                {
+                  *q = 0;
+                }
+              else
+                {
+                  guint32 rb, g;
+
+                  /* Premultiply red and blue with a single multiplication,
+                   * rounding the same way as (c * a + 127) / 255 */
+                  rb = (s & 0x00ff00ff) * a + 0x00800080;
+                  rb = ((rb + ((rb >> 8) & 0x00ff00ff)) >> 8) & 0x00ff00ff;
+                  g = ((s >> 8) & 0xff) * a + 0x80;
+                  g = ((g + (g >> 8)) >> 8) & 0xff;
+
+                  *q = (a << 24) | ((rb & 0xff) << 16) | (g << 8) | (rb >> 16);
+                }
 
               p += 4;
-              q += 4;
+              q++;
             }
-
-#undef MULT
         }
 
       gdk_pixels += gdk_rowstride;
@@ -17,6 +17,7 @@
 #include "config.h"
 
 #include "gdkpixbufutilsprivate.h"
+#include "gtkintl.h"
 
 static GdkPixbuf *
 load_from_stream (GdkPixbufLoader  *loader,
@@ -130,3 +131,205 @@ _gdk_pixbuf_new_from_resource_scaled (const gchar  *resource_path,
   return pixbuf;
 }
 
+
+static gchar *
+rgba_to_string_noalpha (const GdkRGBA *rgba)
+{
+  GdkRGBA color;
+
+  color = *rgba;
+  color.alpha = 1.0;
+
+  return gdk_rgba_to_string (&color);
+}
+
+/* Renders the symbolic SVG in @file_data, which is @svg_width by
+ * @svg_height in size, at @width by @height with the given colors.
+ * The alpha of @fg applies to the whole icon.
+ */
+GdkPixbuf *
+_gdk_pixbuf_new_symbolic_from_data (const gchar    *file_data,
+                                    gsize           file_len,
+                                    gint            svg_width,
+                                    gint            svg_height,
+                                    gint            width,
+                                    gint            height,
+                                    const GdkRGBA  *fg,
+                                    const GdkRGBA  *success_color,
+                                    const GdkRGBA  *warning_color,
+                                    const GdkRGBA  *error_color,
+                                    GError        **error)
+{
+  GInputStream *stream;
+  GdkPixbuf *pixbuf;
+  gchar *css_fg;
+  gchar *css_success;
+  gchar *css_warning;
+  gchar *css_error;
+  gchar *data;
+  gchar *svg_width_str;
+  gchar *svg_height_str;
+  gchar *escaped_file_data;
+  gchar alphastr[G_ASCII_DTOSTR_BUF_SIZE];
+
+  css_fg = rgba_to_string_noalpha (fg);
+  css_warning = rgba_to_string_noalpha (warning_color);
+  css_error = rgba_to_string_noalpha (error_color);
+  css_success = rgba_to_string_noalpha (success_color);
+
+  svg_width_str = g_strdup_printf ("%d", svg_width);
+  svg_height_str = g_strdup_printf ("%d", svg_height);
+
+  escaped_file_data = g_base64_encode ((guchar *) file_data, file_len);
+
+  g_ascii_dtostr (alphastr, G_ASCII_DTOSTR_BUF_SIZE, CLAMP (fg->alpha, 0, 1));
+
+  data = g_strconcat ("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n"
+                      "<svg version=\"1.1\"\n"
+                      "     xmlns=\"http://www.w3.org/2000/svg\"\n"
+                      "     xmlns:xi=\"http://www.w3.org/2001/XInclude\"\n"
+                      "     width=\"", svg_width_str, "\"\n"
+                      "     height=\"", svg_height_str, "\">\n"
+                      "  <style type=\"text/css\">\n"
+                      "    rect,path,ellipse,circle,polygon {\n"
+                      "      fill: ", css_fg," !important;\n"
+                      "    }\n"
+                      "    .warning {\n"
+                      "      fill: ", css_warning, " !important;\n"
+                      "    }\n"
+                      "    .error {\n"
+                      "      fill: ", css_error ," !important;\n"
+                      "    }\n"
+                      "    .success {\n"
+                      "      fill: ", css_success, " !important;\n"
+                      "    }\n"
+                      "  </style>\n"
+                      "  <g opacity=\"", alphastr, "\" ><xi:include href=\"data:text/xml;base64,", escaped_file_data, "\"/></g>\n"
+                      "</svg>",
+                      NULL);
+  g_free (escaped_file_data);
+  g_free (css_fg);
+  g_free (css_warning);
+  g_free (css_error);
+  g_free (css_success);
+  g_free (svg_width_str);
+  g_free (svg_height_str);
+
+  stream = g_memory_input_stream_new_from_data (data, -1, g_free);
+  pixbuf = gdk_pixbuf_new_from_stream_at_scale (stream,
+                                                width,
+                                                height,
+                                                TRUE,
+                                                NULL,
+                                                error);
+  g_object_unref (stream);
+
+  return pixbuf;
+}
+
+static void
+extract_plane (GdkPixbuf *src,
+               GdkPixbuf *dst,
+               int        from_plane,
+               int        to_plane)
+{
+  guchar *src_data, *dst_data;
+  int width, height, src_stride, dst_stride;
+  guchar *src_row, *dst_row;
+  int x, y;
+
+  width = MIN (gdk_pixbuf_get_width (src), gdk_pixbuf_get_width (dst));
+  height = MIN (gdk_pixbuf_get_height (src), gdk_pixbuf_get_height (dst));
+
+  src_stride = gdk_pixbuf_get_rowstride (src);
+  src_data = gdk_pixbuf_get_pixels (src);
+
+  dst_data = gdk_pixbuf_get_pixels (dst);
+  dst_stride = gdk_pixbuf_get_rowstride (dst);
+
+  for (y = 0; y < height; y++)
+    {
+      src_row = src_data + src_stride * y;
+      dst_row = dst_data + dst_stride * y;
+      for (x = 0; x < width; x++)
+        {
+          dst_row[to_plane] = src_row[from_plane];
+          src_row += 4;
+          dst_row += 4;
+        }
+    }
+}
+
+/* Renders the symbolic SVG in @file_data into the encoding of
+ * .symbolic.png files, which any set of colors can be applied to
+ * without rendering again: the alpha channel holds the coverage of
+ * the icon and the red, green and blue channels the fraction of the
+ * success, warning and error colors. This takes three renderings.
+ */
+GdkPixbuf *
+_gdk_pixbuf_new_symbolic_encoded_from_data (const gchar  *file_data,
+                                            gsize         file_len,
+                                            gint          svg_width,
+                                            gint          svg_height,
+                                            gint          width,
+                                            gint          height,
+                                            GError      **error)
+{
+  const GdkRGBA r = { 1, 0, 0, 1 };
+  const GdkRGBA g = { 0, 1, 0, 1 };
+  GdkPixbuf *loaded;
+  GdkPixbuf *pixbuf;
+  int plane;
+
+  pixbuf = gdk_pixbuf_new (GDK_COLORSPACE_RGB, TRUE, 8, width, height);
+  gdk_pixbuf_fill (pixbuf, 0);
+
+  for (plane = 0; plane < 3; plane++)
+    {
+      /* Here we render the svg with all colors solid, this should
+       * always make the alpha channel the same and it should match
+       * the final alpha channel for all possible renderings. We
+       * Just use it as-is for final alpha.
+       *
+       * For the 3 non-fg colors, we render once each with that
+       * color as red, and every other color as green. The resulting
+       * red will describe the amount of that color is in the
+       * opaque part of the color. We store these as the rgb
+       * channels, with the color of the fg being implicitly
+       * the "rest", as all color fractions should add up to 1.
+       */
+      loaded = _gdk_pixbuf_new_symbolic_from_data (file_data, file_len,
+                                                   svg_width, svg_height,
+                                                   width, height,
+                                                   &g,
+                                                   plane == 0 ? &r : &g,
+                                                   plane == 1 ? &r : &g,
+                                                   plane == 2 ? &r : &g,
+                                                   error);
+      if (loaded == NULL)
+        {
+          g_object_unref (pixbuf);
+          return NULL;
+        }
+
+      if (gdk_pixbuf_get_n_channels (loaded) != 4)
+        {
+          g_set_error_literal (error,
+                               GDK_PIXBUF_ERROR,
+                               GDK_PIXBUF_ERROR_FAILED,
+                               _("Failed to load icon"));
+          g_object_unref (loaded);
+          g_object_unref (pixbuf);
+          return NULL;
+        }
+
+      if (plane == 0)
+        extract_plane (loaded, pixbuf, 3, 3);
+
+      extract_plane (loaded, pixbuf, 0, plane);
+
+      g_object_unref (loaded);
+    }
+
+  return pixbuf;
+}
@@ -19,16 +19,36 @@
 #define __GDK_PIXBUF_UTILS_PRIVATE_H__
 
 #include <gdk-pixbuf/gdk-pixbuf.h>
+#include <gdk/gdk.h>
 
 G_BEGIN_DECLS
 
-GdkPixbuf *_gdk_pixbuf_new_from_stream_scaled   (GInputStream  *stream,
-                                                 gdouble        scale,
-                                                 GCancellable  *cancellable,
-                                                 GError       **error);
-GdkPixbuf *_gdk_pixbuf_new_from_resource_scaled (const gchar   *resource_path,
-                                                 gdouble        scale,
-                                                 GError       **error);
+GdkPixbuf *_gdk_pixbuf_new_from_stream_scaled         (GInputStream   *stream,
+                                                       gdouble         scale,
+                                                       GCancellable   *cancellable,
+                                                       GError        **error);
+GdkPixbuf *_gdk_pixbuf_new_from_resource_scaled       (const gchar    *resource_path,
+                                                       gdouble         scale,
+                                                       GError        **error);
+
+GdkPixbuf *_gdk_pixbuf_new_symbolic_from_data         (const gchar    *file_data,
+                                                       gsize           file_len,
+                                                       gint            svg_width,
+                                                       gint            svg_height,
+                                                       gint            width,
+                                                       gint            height,
+                                                       const GdkRGBA  *fg,
+                                                       const GdkRGBA  *success_color,
+                                                       const GdkRGBA  *warning_color,
+                                                       const GdkRGBA  *error_color,
+                                                       GError        **error);
+GdkPixbuf *_gdk_pixbuf_new_symbolic_encoded_from_data (const gchar    *file_data,
+                                                       gsize           file_len,
+                                                       gint            svg_width,
+                                                       gint            svg_height,
+                                                       gint            width,
+                                                       gint            height,
+                                                       GError        **error);
 
 G_END_DECLS
 
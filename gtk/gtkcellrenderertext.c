@@ -176,6 +176,7 @@ struct _GtkCellRendererTextPrivate
 
   gchar *text;
   gchar *placeholder_text;
+  gchar *markup;        /* what text and extra_attrs were parsed from */
 
   gdouble font_scale;
 
@@ -205,8 +206,27 @@ struct _GtkCellRendererTextPrivate
   gulong focus_out_id;
   gulong populate_popup_id;
   gulong entry_menu_popdown_timeout;
+
+  /* get_preferred_width() results for the texts and fonts measured with
+   * the current settings, valid for one pango context and padding
+   */
+  GHashTable   *width_cache;
+  PangoContext *width_cache_context;
+  guint         width_cache_serial;
+  gint          width_cache_xpad;
 };
 
+#define WIDTH_CACHE_MAX_SIZE 1024
+
+typedef struct
+{
+  gchar *text;          /* the markup if is_markup is set */
+  PangoFontDescription *font;
+  gboolean is_markup;
+  gint minimum;
+  gint natural;
+} CachedWidth;
+
 G_DEFINE_TYPE_WITH_PRIVATE (GtkCellRendererText, gtk_cell_renderer_text, GTK_TYPE_CELL_RENDERER)
 
 static void
@@ -696,6 +716,179 @@ G_GNUC_END_IGNORE_DEPRECATIONS
   gtk_cell_renderer_class_set_accessible_type (cell_class, GTK_TYPE_TEXT_CELL_ACCESSIBLE);
 }
 
+static guint
+cached_width_hash (gconstpointer key)
+{
+  const CachedWidth *cached = key;
+
+  return g_str_hash (cached->text) ^ pango_font_description_hash (cached->font) ^ cached->is_markup;
+}
+
+static gboolean
+cached_width_equal (gconstpointer a,
+                    gconstpointer b)
+{
+  const CachedWidth *cached_a = a;
+  const CachedWidth *cached_b = b;
+
+  return cached_a->is_markup == cached_b->is_markup &&
+         g_str_equal (cached_a->text, cached_b->text) &&
+         pango_font_description_equal (cached_a->font, cached_b->font);
+}
+
+static void
+cached_width_free (gpointer data)
+{
+  CachedWidth *cached = data;
+
+  g_free (cached->text);
+  pango_font_description_free (cached->font);
+  g_slice_free (CachedWidth, cached);
+}
+
+static void
+gtk_cell_renderer_text_clear_width_cache (GtkCellRendererText *celltext)
+{
+  GtkCellRendererTextPrivate *priv = celltext->priv;
+
+  g_clear_pointer (&priv->width_cache, g_hash_table_unref);
+  g_clear_object (&priv->width_cache_context);
+}
+
+/* Many cells in a column show the same few texts, so remember the width
+ * of every text we measured. The font is part of the key since it is
+ * commonly set per row, and so is the markup for columns showing markup;
+ * any other change to properties that affect the size of the text clears
+ * the cache, as does a change to the widget's pango context.
+ */
+static gboolean
+gtk_cell_renderer_text_get_width_key (GtkCellRendererText *celltext,
+                                      CachedWidth         *key)
+{
+  GtkCellRendererTextPrivate *priv = celltext->priv;
+
+  /* Attributes set after the markup aren't part of any key */
+  if (priv->markup_set && priv->markup == NULL)
+    return FALSE;
+
+  key->is_markup = priv->markup_set;
+  key->text = priv->markup_set ? priv->markup : priv->text;
+  if (key->text == NULL)
+    key->text = "";
+  key->font = priv->font;
+
+  return TRUE;
+}
+
+static CachedWidth *
+gtk_cell_renderer_text_lookup_width (GtkCellRendererText *celltext,
+                                     GtkWidget           *widget,
+                                     gint                 xpad)
+{
+  GtkCellRendererTextPrivate *priv = celltext->priv;
+  PangoContext *context;
+  CachedWidth key;
+
+  context = gtk_widget_get_pango_context (widget);
+
+  if (priv->width_cache == NULL ||
+      priv->width_cache_context != context ||
+      priv->width_cache_serial != pango_context_get_serial (context) ||
+      priv->width_cache_xpad != xpad)
+    {
+      gtk_cell_renderer_text_clear_width_cache (celltext);
+      return NULL;
+    }
+
+  if (!gtk_cell_renderer_text_get_width_key (celltext, &key))
+    return NULL;
+
+  return g_hash_table_lookup (priv->width_cache, &key);
+}
+
+static void
+gtk_cell_renderer_text_store_width (GtkCellRendererText *celltext,
+                                    GtkWidget           *widget,
+                                    gint                 xpad,
+                                    gint                 minimum,
+                                    gint                 natural)
+{
+  GtkCellRendererTextPrivate *priv = celltext->priv;
+  PangoContext *context;
+  CachedWidth key, *cached;
+
+  if (!gtk_cell_renderer_text_get_width_key (celltext, &key))
+    return;
+
+  context = gtk_widget_get_pango_context (widget);
+
+  if (priv->width_cache == NULL ||
+      g_hash_table_size (priv->width_cache) >= WIDTH_CACHE_MAX_SIZE)
+    {
+      gtk_cell_renderer_text_clear_width_cache (celltext);
+
+      priv->width_cache = g_hash_table_new_full (cached_width_hash,
+                                                 cached_width_equal,
+                                                 cached_width_free,
+                                                 NULL);
+      priv->width_cache_context = g_object_ref (context);
+      priv->width_cache_serial = pango_context_get_serial (context);
+      priv->width_cache_xpad = xpad;
+    }
+
+  cached = g_slice_new (CachedWidth);
+  cached->text = g_strdup (key.text);
+  cached->font = pango_font_description_copy (key.font);
+  cached->is_markup = key.is_markup;
+  cached->minimum = minimum;
+  cached->natural = natural;
+
+  g_hash_table_add (priv->width_cache, cached);
+}
+
+static gboolean
+property_affects_width (guint param_id)
+{
+  switch (param_id)
+    {
+    /* The text, markup and font are part of the width cache's key */
+    case PROP_TEXT:
+    case PROP_MARKUP:
+    case PROP_FONT:
+    case PROP_FONT_DESC:
+    case PROP_FAMILY:
+    case PROP_STYLE:
+    case PROP_VARIANT:
+    case PROP_WEIGHT:
+    case PROP_STRETCH:
+    case PROP_SIZE:
+    case PROP_SIZE_POINTS:
+    case PROP_FAMILY_SET:
+    case PROP_STYLE_SET:
+    case PROP_VARIANT_SET:
+    case PROP_WEIGHT_SET:
+    case PROP_STRETCH_SET:
+    case PROP_SIZE_SET:
+    /* These only change the appearance */
+    case PROP_ALIGN:
+    case PROP_ALIGN_SET:
+    case PROP_BACKGROUND:
+    case PROP_FOREGROUND:
+    case PROP_BACKGROUND_GDK:
+    case PROP_FOREGROUND_GDK:
+    case PROP_BACKGROUND_RGBA:
+    case PROP_FOREGROUND_RGBA:
+    case PROP_BACKGROUND_SET:
+    case PROP_FOREGROUND_SET:
+    case PROP_STRIKETHROUGH:
+    case PROP_STRIKETHROUGH_SET:
+      return FALSE;
+
+    default:
+      return TRUE;
+    }
+}
+
 static void
 gtk_cell_renderer_text_finalize (GObject *object)
 {
@@ -706,6 +899,9 @@ gtk_cell_renderer_text_finalize (GObject *object)
 
   g_free (priv->text);
   g_free (priv->placeholder_text);
+  g_free (priv->markup);
+
+  gtk_cell_renderer_text_clear_width_cache (celltext);
 
   if (priv->extra_attrs)
     pango_attr_list_unref (priv->extra_attrs);
@@ -1121,6 +1317,11 @@ gtk_cell_renderer_text_set_property (GObject      *object,
   GtkCellRendererText *celltext = GTK_CELL_RENDERER_TEXT (object);
   GtkCellRendererTextPrivate *priv = celltext->priv;
 
+  /* Setting the text drops the attributes set with markup */
+  if (property_affects_width (param_id) ||
+      (param_id == PROP_TEXT && priv->markup_set))
+    gtk_cell_renderer_text_clear_width_cache (celltext);
+
   switch (param_id)
     {
     case PROP_TEXT:
@@ -1132,6 +1333,7 @@ gtk_cell_renderer_text_set_property (GObject      *object,
             pango_attr_list_unref (priv->extra_attrs);
           priv->extra_attrs = NULL;
           priv->markup_set = FALSE;
+          g_clear_pointer (&priv->markup, g_free);
         }
 
       priv->text = g_value_dup_string (value);
@@ -1141,6 +1343,7 @@ gtk_cell_renderer_text_set_property (GObject      *object,
     case PROP_ATTRIBUTES:
       if (priv->extra_attrs)
 	pango_attr_list_unref (priv->extra_attrs);
+      g_clear_pointer (&priv->markup, g_free);
 
       priv->extra_attrs = g_value_get_boxed (value);
       if (priv->extra_attrs)
@@ -1170,6 +1373,8 @@ gtk_cell_renderer_text_set_property (GObject      *object,
 	priv->text = text;
 	priv->extra_attrs = attrs;
         priv->markup_set = TRUE;
+        g_free (priv->markup);
+        priv->markup = g_strdup (str);
       }
       break;
 
@@ -1550,24 +1755,25 @@ add_attr (PangoAttrList  *attr_list,
   pango_attr_list_insert (attr_list, attr);
 }
 
+/* Creates a layout with all attributes set up, but without setting
+ * its width. Size requests that set the width themselves use this
+ * directly, so the text does not get shaped for the wrap width first.
+ */
 static PangoLayout*
-get_layout (GtkCellRendererText *celltext,
-            GtkWidget           *widget,
-            const GdkRectangle  *cell_area,
-            GtkCellRendererState flags)
+create_layout (GtkCellRendererText *celltext,
+               GtkWidget           *widget,
+               const GdkRectangle  *cell_area,
+               GtkCellRendererState flags)
 {
   GtkCellRendererTextPrivate *priv = celltext->priv;
   PangoAttrList *attr_list;
   PangoLayout *layout;
   PangoUnderline uline;
-  gint xpad;
   gboolean placeholder_layout = show_placeholder_text (celltext);
 
   layout = gtk_widget_create_pango_layout (widget, placeholder_layout ?
                                            priv->placeholder_text : priv->text);
 
-  gtk_cell_renderer_get_padding (GTK_CELL_RENDERER (celltext), &xpad, NULL);
-
   if (priv->extra_attrs)
     attr_list = pango_attr_list_copy (priv->extra_attrs);
   else
@@ -1671,6 +1877,42 @@ get_layout (GtkCellRendererText *celltext,
   else
     pango_layout_set_ellipsize (layout, PANGO_ELLIPSIZE_NONE);
 
+  if (priv->wrap_width != -1)
+    pango_layout_set_wrap (layout, priv->wrap_mode);
+  else
+    pango_layout_set_wrap (layout, PANGO_WRAP_CHAR);
+
+  if (priv->align_set)
+    pango_layout_set_alignment (layout, priv->align);
+  else
+    {
+      PangoAlignment align;
+
+      if (gtk_widget_get_direction (widget) == GTK_TEXT_DIR_RTL)
+	align = PANGO_ALIGN_RIGHT;
+      else
+	align = PANGO_ALIGN_LEFT;
+
+      pango_layout_set_alignment (layout, align);
+    }
+  
+  return layout;
+}
+
+static PangoLayout*
+get_layout (GtkCellRendererText *celltext,
+            GtkWidget           *widget,
+            const GdkRectangle  *cell_area,
+            GtkCellRendererState flags)
+{
+  GtkCellRendererTextPrivate *priv = celltext->priv;
+  PangoLayout *layout;
+  gint xpad;
+
+  layout = create_layout (celltext, widget, cell_area, flags);
+
+  gtk_cell_renderer_get_padding (GTK_CELL_RENDERER (celltext), &xpad, NULL);
+
   if (priv->wrap_width != -1)
     {
       PangoRectangle rect;
@@ -1687,28 +1929,12 @@ get_layout (GtkCellRendererText *celltext,
       width = MIN (width, text_width);
 
       pango_layout_set_width (layout, width);
-      pango_layout_set_wrap (layout, priv->wrap_mode);
     }
   else
     {
       pango_layout_set_width (layout, -1);
-      pango_layout_set_wrap (layout, PANGO_WRAP_CHAR);
     }
 
-  if (priv->align_set)
-    pango_layout_set_alignment (layout, priv->align);
-  else
-    {
-      PangoAlignment align;
-
-      if (gtk_widget_get_direction (widget) == GTK_TEXT_DIR_RTL)
-	align = PANGO_ALIGN_RIGHT;
-      else
-	align = PANGO_ALIGN_LEFT;
-
-      pango_layout_set_alignment (layout, align);
-    }
-  
   return layout;
 }
 
@@ -2111,6 +2337,7 @@ gtk_cell_renderer_text_get_preferred_width (GtkCellRenderer *cell,
   PangoContext               *context;
   PangoFontMetrics           *metrics;
   PangoRectangle              rect;
+  CachedWidth                *cached;
   gint char_width, text_width, ellipsize_chars, xpad;
   gint min_width, nat_width;
 
@@ -2128,7 +2355,19 @@ gtk_cell_renderer_text_get_preferred_width (GtkCellRenderer *cell,
 
   gtk_cell_renderer_get_padding (cell, &xpad, NULL);
 
-  layout = get_layout (celltext, widget, NULL, 0);
+  cached = gtk_cell_renderer_text_lookup_width (celltext, widget, xpad);
+  if (cached)
+    {
+      if (minimum_size)
+        *minimum_size = cached->minimum;
+
+      if (natural_size)
+        *natural_size = cached->natural;
+
+      return;
+    }
+
+  layout = create_layout (celltext, widget, NULL, 0);
 
   /* Fetch the length of the complete unwrapped text */
   pango_layout_set_width (layout, -1);
@@ -2178,6 +2417,8 @@ gtk_cell_renderer_text_get_preferred_width (GtkCellRenderer *cell,
       nat_width = MIN (nat_width, max_width);
     }
 
+  gtk_cell_renderer_text_store_width (celltext, widget, xpad, min_width, nat_width);
+
   if (minimum_size)
     *minimum_size = min_width;
 
@@ -2201,7 +2442,7 @@ gtk_cell_renderer_text_get_preferred_height_for_width (GtkCellRenderer *cell,
 
   gtk_cell_renderer_get_padding (cell, &xpad, &ypad);
 
-  layout = get_layout (celltext, widget, NULL, 0);
+  layout = create_layout (celltext, widget, NULL, 0);
 
   pango_layout_set_width (layout, (width - xpad * 2) * PANGO_SCALE);
   pango_layout_get_pixel_size (layout, NULL, &text_height);
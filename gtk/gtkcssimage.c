@@ -19,6 +19,9 @@
 
 #include "config.h"
 
+#include <math.h>
+#include <string.h>
+
 #include "gtkcssimageprivate.h"
 
 #include "gtkcssstyleprivate.h"
@@ -410,6 +413,185 @@ _gtk_css_image_get_surface (GtkCssImage     *image,
   return result;
 }
 
+/**
+ * _gtk_css_image_render_cache_lookup:
+ * @cache: the entries of the cache, most recently used first
+ * @n_cache: the number of entries in @cache
+ * @width: the width of the wanted rendering
+ * @height: the height of the wanted rendering
+ * @x_scale: the horizontal device scale of the wanted rendering
+ * @y_scale: the vertical device scale of the wanted rendering
+ *
+ * Looks for a rendering of the given size and scale in @cache and
+ * moves it to the front. If there is none, the least recently used
+ * entry is dropped and the first one is set up for the caller to
+ * store its rendering in.
+ *
+ * Returns: %TRUE if the first entry of @cache holds a matching
+ *     rendering, %FALSE if its surface needs to be created
+ */
+gboolean
+_gtk_css_image_render_cache_lookup (GtkCssImageRenderCache *cache,
+                                    guint                   n_cache,
+                                    double                  width,
+                                    double                  height,
+                                    double                  x_scale,
+                                    double                  y_scale)
+{
+  GtkCssImageRenderCache entry;
+  guint i;
+
+  g_return_val_if_fail (n_cache > 0, FALSE);
+
+  for (i = 0; i < n_cache; i++)
+    {
+      if (cache[i].surface == NULL)
+        break;
+
+      if (ABS (width - cache[i].width) > 0.001 ||
+          ABS (height - cache[i].height) > 0.001 ||
+          x_scale != cache[i].x_scale ||
+          y_scale != cache[i].y_scale)
+        continue;
+
+      /* Move to the front */
+      entry = cache[i];
+      memmove (&cache[1], &cache[0], i * sizeof (GtkCssImageRenderCache));
+      cache[0] = entry;
+
+      return TRUE;
+    }
+
+  /* Drop the least recently used one */
+  i = n_cache - 1;
+  g_clear_pointer (&cache[i].surface, cairo_surface_destroy);
+  memmove (&cache[1], &cache[0], i * sizeof (GtkCssImageRenderCache));
+
+  cache[0].surface = NULL;
+  cache[0].width = width;
+  cache[0].height = height;
+  cache[0].x_scale = x_scale;
+  cache[0].y_scale = y_scale;
+
+  return FALSE;
+}
+
+/**
+ * _gtk_css_image_render_cache_draw:
+ * @cache: the entries of the cache to use
+ * @n_cache: the number of entries in @cache
+ * @image: the image being drawn
+ * @cr: the context to draw to
+ * @width: the width to draw the image at
+ * @height: the height to draw the image at
+ * @cache_width: the width of the area to keep, at most @width
+ * @cache_height: the height of the area to keep, at most @height
+ * @render: function drawing @image without the cache
+ *
+ * Draws @image from a rendering kept in @cache, rendering it with
+ * @render at @cache_width x @cache_height first if there is none of
+ * that size and scale. Images that repeat along an axis can pass a
+ * smaller @cache_width or @cache_height, as long as drawing them at
+ * that size gives the same pixels they have at @width x @height; the
+ * cached area is tiled to fill the rest. Draws of different sizes that
+ * need the same area share its rendering.
+ *
+ * The cache is only used when @cr targets pixels without scaling or
+ * rotation and the image covers whole device pixels, so that blitting
+ * gives the same result as drawing.
+ *
+ * Returns: %FALSE if the cache could not be used and the caller
+ *     needs to draw @image itself
+ */
+gboolean
+_gtk_css_image_render_cache_draw (GtkCssImageRenderCache *cache,
+                                  guint                   n_cache,
+                                  GtkCssImage            *image,
+                                  cairo_t                *cr,
+                                  double                  width,
+                                  double                  height,
+                                  double                  cache_width,
+                                  double                  cache_height,
+                                  void                  (* render) (GtkCssImage *image,
+                                                                    cairo_t     *cr,
+                                                                    double       width,
+                                                                    double       height))
+{
+  cairo_surface_t *target;
+  cairo_matrix_t matrix;
+  double x_scale, y_scale;
+  double x, y;
+
+  target = cairo_get_target (cr);
+  switch ((guint) cairo_surface_get_type (target))
+    {
+    case CAIRO_SURFACE_TYPE_IMAGE:
+    case CAIRO_SURFACE_TYPE_XLIB:
+    case CAIRO_SURFACE_TYPE_XCB:
+    case CAIRO_SURFACE_TYPE_WIN32:
+    case CAIRO_SURFACE_TYPE_QUARTZ:
+      break;
+    default:
+      /* Don't turn vector output into pixels */
+      return FALSE;
+    }
+
+  cairo_get_matrix (cr, &matrix);
+  if (matrix.xx != 1.0 || matrix.yy != 1.0 || matrix.xy != 0.0 || matrix.yx != 0.0)
+    return FALSE;
+
+  x = y = 0;
+  cairo_user_to_device (cr, &x, &y);
+  cairo_surface_get_device_scale (target, &x_scale, &y_scale);
+  x *= x_scale;
+  y *= y_scale;
+  if (x != floor (x) || y != floor (y) ||
+      width * x_scale != floor (width * x_scale) ||
+      height * y_scale != floor (height * y_scale) ||
+      cache_width * x_scale != floor (cache_width * x_scale) ||
+      cache_height * y_scale != floor (cache_height * y_scale))
+    return FALSE;
+
+  /* Gradients are cheap enough to draw again at that size */
+  if (cache_width * x_scale * cache_height * y_scale > GTK_CSS_IMAGE_RENDER_CACHE_MAX_PIXELS)
+    return FALSE;
+
+  if (!_gtk_css_image_render_cache_lookup (cache, n_cache,
+                                           cache_width, cache_height,
+                                           x_scale, y_scale))
+    {
+      cairo_t *cache_cr;
+
+      cache->surface = cairo_surface_create_similar_image (target,
+                                                           CAIRO_FORMAT_ARGB32,
+                                                           cache_width * x_scale,
+                                                           cache_height * y_scale);
+      cairo_surface_set_device_scale (cache->surface, x_scale, y_scale);
+
+      cache_cr = cairo_create (cache->surface);
+      render (image, cache_cr, cache_width, cache_height);
+      cairo_destroy (cache_cr);
+    }
+
+  cairo_set_source_surface (cr, cache->surface, 0, 0);
+  cairo_pattern_set_extend (cairo_get_source (cr), CAIRO_EXTEND_REPEAT);
+  cairo_pattern_set_filter (cairo_get_source (cr), CAIRO_FILTER_NEAREST);
+  cairo_rectangle (cr, 0, 0, width, height);
+  cairo_fill (cr);
+
+  return TRUE;
+}
+
+void
+_gtk_css_image_render_cache_clear (GtkCssImageRenderCache *cache,
+                                   guint                   n_cache)
+{
+  guint i;
+
+  for (i = 0; i < n_cache; i++)
+    g_clear_pointer (&cache[i].surface, cairo_surface_destroy);
+}
+
 static GType
 gtk_css_image_get_parser_type (GtkCssParser *parser)
 {
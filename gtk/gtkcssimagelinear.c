@@ -128,10 +128,10 @@ gtk_css_image_linear_compute_start_point (double angle_in_degrees,
 }
                                          
 static void
-gtk_css_image_linear_draw (GtkCssImage        *image,
-                           cairo_t            *cr,
-                           double              width,
-                           double              height)
+gtk_css_image_linear_render (GtkCssImage        *image,
+                             cairo_t            *cr,
+                             double              width,
+                             double              height)
 {
   GtkCssImageLinear *linear = GTK_CSS_IMAGE_LINEAR (image);
   cairo_pattern_t *pattern;
@@ -236,6 +236,50 @@ gtk_css_image_linear_draw (GtkCssImage        *image,
   cairo_pattern_destroy (pattern);
 }
 
+/* Gradients along one axis don't change along the other one, so a few
+ * pixels of them can be kept and repeated. */
+#define STRIP_SIZE 32
+
+static void
+gtk_css_image_linear_draw (GtkCssImage        *image,
+                           cairo_t            *cr,
+                           double              width,
+                           double              height)
+{
+  GtkCssImageLinear *linear = GTK_CSS_IMAGE_LINEAR (image);
+  double cache_width, cache_height;
+  double angle;
+
+  cache_width = width;
+  cache_height = height;
+
+  if (linear->side)
+    {
+      if (linear->side == 1 << GTK_CSS_TOP || linear->side == 1 << GTK_CSS_BOTTOM)
+        cache_width = MIN (width, STRIP_SIZE);
+      else if (linear->side == 1 << GTK_CSS_LEFT || linear->side == 1 << GTK_CSS_RIGHT)
+        cache_height = MIN (height, STRIP_SIZE);
+    }
+  else
+    {
+      angle = fmod (_gtk_css_number_value_get (linear->angle, 100), 180);
+      if (angle < 0)
+        angle += 180;
+
+      if (angle == 0)
+        cache_width = MIN (width, STRIP_SIZE);
+      else if (angle == 90)
+        cache_height = MIN (height, STRIP_SIZE);
+    }
+
+  if (!_gtk_css_image_render_cache_draw (linear->cache, G_N_ELEMENTS (linear->cache),
+                                         image, cr,
+                                         width, height,
+                                         cache_width, cache_height,
+                                         gtk_css_image_linear_render))
+    gtk_css_image_linear_render (image, cr, width, height);
+}
+
 
 static gboolean
 gtk_css_image_linear_parse (GtkCssImage  *image,
@@ -595,6 +639,8 @@ gtk_css_image_linear_dispose (GObject *object)
       linear->angle = NULL;
     }
 
+  _gtk_css_image_render_cache_clear (linear->cache, G_N_ELEMENTS (linear->cache));
+
   G_OBJECT_CLASS (_gtk_css_image_linear_parent_class)->dispose (object);
 }
 
@@ -49,6 +49,8 @@ struct _GtkCssImageLinear
   GtkCssValue *angle;
   GArray *stops;
   guint repeating :1;
+
+  GtkCssImageRenderCache cache[GTK_CSS_IMAGE_RENDER_CACHE_SIZE]; /* renderings, most recently used first */
 };
 
 struct _GtkCssImageLinearClass
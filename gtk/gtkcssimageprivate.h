@@ -37,6 +37,7 @@ G_BEGIN_DECLS
 
 typedef struct _GtkCssImage           GtkCssImage;
 typedef struct _GtkCssImageClass      GtkCssImageClass;
+typedef struct _GtkCssImageRenderCache GtkCssImageRenderCache;
 
 struct _GtkCssImage
 {
@@ -82,6 +83,21 @@ struct _GtkCssImageClass
                                                     GString                    *string);
 };
 
+/* Number of renderings images keep around */
+#define GTK_CSS_IMAGE_RENDER_CACHE_SIZE 4
+/* Renderings larger than this are not worth keeping around more than once */
+#define GTK_CSS_IMAGE_RENDER_CACHE_MAX_PIXELS (256 * 256)
+
+/* rendering of an image at one size, kept to be blitted on later draws */
+struct _GtkCssImageRenderCache
+{
+  cairo_surface_t *surface;
+  double width;
+  double height;
+  double x_scale;
+  double y_scale;
+};
+
 GType          _gtk_css_image_get_type             (void) G_GNUC_CONST;
 
 gboolean       _gtk_css_image_can_parse            (GtkCssParser               *parser);
@@ -123,6 +139,27 @@ cairo_surface_t *
                                                     int                         surface_width,
                                                     int                         surface_height);
 
+gboolean       _gtk_css_image_render_cache_lookup  (GtkCssImageRenderCache     *cache,
+                                                    guint                       n_cache,
+                                                    double                      width,
+                                                    double                      height,
+                                                    double                      x_scale,
+                                                    double                      y_scale);
+gboolean       _gtk_css_image_render_cache_draw    (GtkCssImageRenderCache     *cache,
+                                                    guint                       n_cache,
+                                                    GtkCssImage                *image,
+                                                    cairo_t                    *cr,
+                                                    double                      width,
+                                                    double                      height,
+                                                    double                      cache_width,
+                                                    double                      cache_height,
+                                                    void                      (* render) (GtkCssImage *image,
+                                                                                          cairo_t     *cr,
+                                                                                          double       width,
+                                                                                          double       height));
+void           _gtk_css_image_render_cache_clear   (GtkCssImageRenderCache     *cache,
+                                                    guint                       n_cache);
+
 G_END_DECLS
 
 #endif /* __GTK_CSS_IMAGE_PRIVATE_H__ */
@@ -74,10 +74,10 @@ gtk_css_image_radial_get_start_end (GtkCssImageRadial *radial,
 }
 
 static void
-gtk_css_image_radial_draw (GtkCssImage *image,
-                           cairo_t     *cr,
-                           double       width,
-                           double       height)
+gtk_css_image_radial_render (GtkCssImage *image,
+                             cairo_t     *cr,
+                             double       width,
+                             double       height)
 {
   GtkCssImageRadial *radial = GTK_CSS_IMAGE_RADIAL (image);
   cairo_pattern_t *pattern;
@@ -227,6 +227,22 @@ gtk_css_image_radial_draw (GtkCssImage *image,
   cairo_pattern_destroy (pattern);
 }
 
+static void
+gtk_css_image_radial_draw (GtkCssImage *image,
+                           cairo_t     *cr,
+                           double       width,
+                           double       height)
+{
+  GtkCssImageRadial *radial = GTK_CSS_IMAGE_RADIAL (image);
+
+  if (!_gtk_css_image_render_cache_draw (radial->cache, G_N_ELEMENTS (radial->cache),
+                                         image, cr,
+                                         width, height,
+                                         width, height,
+                                         gtk_css_image_radial_render))
+    gtk_css_image_radial_render (image, cr, width, height);
+}
+
 static gboolean
 gtk_css_image_radial_parse (GtkCssImage  *image,
                             GtkCssParser *parser)
@@ -659,6 +675,8 @@ gtk_css_image_radial_dispose (GObject *object)
         radial->sizes[i] = NULL;
       }
 
+  _gtk_css_image_render_cache_clear (radial->cache, G_N_ELEMENTS (radial->cache));
+
   G_OBJECT_CLASS (_gtk_css_image_radial_parent_class)->dispose (object);
 }
 
@@ -59,6 +59,8 @@ struct _GtkCssImageRadial
   GtkCssRadialSize size;
   guint circle : 1;
   guint repeating :1;
+
+  GtkCssImageRenderCache cache[GTK_CSS_IMAGE_RENDER_CACHE_SIZE]; /* renderings, most recently used first */
 };
 
 struct _GtkCssImageRadialClass
@@ -40,6 +40,75 @@ gtk_css_image_surface_get_height (GtkCssImage *image)
   return cairo_image_surface_get_height (surface->surface);
 }
 
+/* Scaling a large image is expensive, so sizes above the limit are kept
+ * too, but only one of them; a resized window background would otherwise
+ * fill every entry with a large copy of itself.
+ */
+static void
+gtk_css_image_surface_drop_large (GtkCssImageSurface *surface)
+{
+  guint i, j;
+
+  for (i = j = 0; i < G_N_ELEMENTS (surface->cache); i++)
+    {
+      cairo_surface_t *scaled = surface->cache[i].surface;
+
+      if (scaled != NULL &&
+          cairo_image_surface_get_width (scaled) * cairo_image_surface_get_height (scaled) >
+          GTK_CSS_IMAGE_RENDER_CACHE_MAX_PIXELS)
+        {
+          cairo_surface_destroy (scaled);
+          continue;
+        }
+
+      surface->cache[j++] = surface->cache[i];
+    }
+
+  for (; j < G_N_ELEMENTS (surface->cache); j++)
+    surface->cache[j].surface = NULL;
+}
+
+/* Returns the image scaled to @width x @height at the given device scale,
+ * reusing one of the recently drawn sizes if possible. */
+static cairo_surface_t *
+gtk_css_image_surface_get_scaled (GtkCssImageSurface *surface,
+                                  double              width,
+                                  double              height,
+                                  double              xscale,
+                                  double              yscale)
+{
+  GtkCssImageRenderCache *entry;
+  cairo_t *cache;
+  int source_width, source_height;
+
+  entry = &surface->cache[0];
+  if (_gtk_css_image_render_cache_lookup (surface->cache, G_N_ELEMENTS (surface->cache),
+                                          width, height, xscale, yscale))
+    return entry->surface;
+
+  source_width = cairo_image_surface_get_width (surface->surface);
+  source_height = cairo_image_surface_get_height (surface->surface);
+
+  if (ceil (width * xscale) * ceil (height * yscale) > GTK_CSS_IMAGE_RENDER_CACHE_MAX_PIXELS)
+    gtk_css_image_surface_drop_large (surface);
+
+  /* Image big enough to contain scaled image with subpixel precision */
+  entry->surface = cairo_surface_create_similar_image (surface->surface,
+                                                       CAIRO_FORMAT_ARGB32,
+                                                       ceil (width * xscale),
+                                                       ceil (height * yscale));
+  cairo_surface_set_device_scale (entry->surface, xscale, yscale);
+  cache = cairo_create (entry->surface);
+  cairo_rectangle (cache, 0, 0, width, height);
+  cairo_scale (cache, width / source_width, height / source_height);
+  cairo_set_source_surface (cache, surface->surface, 0, 0);
+  cairo_pattern_set_filter (cairo_get_source (cache), CAIRO_FILTER_GOOD);
+  cairo_fill (cache);
+  cairo_destroy (cache);
+
+  return entry->surface;
+}
+
 static void
 gtk_css_image_surface_draw (GtkCssImage *image,
                             cairo_t     *cr,
@@ -48,6 +117,7 @@ gtk_css_image_surface_draw (GtkCssImage *image,
 {
   GtkCssImageSurface *surface = GTK_CSS_IMAGE_SURFACE (image);
   int image_width, image_height;
+  double xscale, yscale;
 
   image_width = cairo_image_surface_get_width (surface->surface);
   image_height = cairo_image_surface_get_height (surface->surface);
@@ -55,43 +125,26 @@ gtk_css_image_surface_draw (GtkCssImage *image,
   if (image_width == 0 || image_height == 0 || width <= 0 || height <= 0)
     return;
 
-  /* Update cache image if size is different */
-  if (surface->cache == NULL   ||
-      ABS (width - surface->width) > 0.001 ||
-      ABS (height - surface->height) > 0.001)
+  /* We need the device scale (HiDPI mode) to calculate the proper size in
+   * pixels for the image surface and set the cache device scale
+   */
+  cairo_surface_get_device_scale (cairo_get_target (cr), &xscale, &yscale);
+
+  cairo_rectangle (cr, 0, 0, width, height);
+
+  if (width * xscale == image_width && height * yscale == image_height)
     {
-      double xscale, yscale;
-      cairo_t *cache;
-
-      /* We need the device scale (HiDPI mode) to calculate the proper size in
-       * pixels for the image surface and set the cache device scale
-       */
-      cairo_surface_get_device_scale (cairo_get_target (cr), &xscale, &yscale);
-
-      /* Save original size to preserve precision */
-      surface->width = width;
-      surface->height = height;
-
-      /* Destroy old cache if any */
-      g_clear_pointer (&surface->cache, cairo_surface_destroy);
-
-      /* Image big enough to contain scaled image with subpixel precision */
-      surface->cache = cairo_surface_create_similar_image (surface->surface,
-                                                           CAIRO_FORMAT_ARGB32,
-                                                           ceil (width*xscale),
-                                                           ceil (height*yscale));
-      cairo_surface_set_device_scale (surface->cache, xscale, yscale);
-      cache = cairo_create (surface->cache);
-      cairo_rectangle (cache, 0, 0, width, height);
-      cairo_scale (cache, width / image_width, height / image_height);
-      cairo_set_source_surface (cache, surface->surface, 0, 0);
-      cairo_fill (cache);
-
-      cairo_destroy (cache);
+      /* No scaling needed, draw the image as is */
+      cairo_scale (cr, 1 / xscale, 1 / yscale);
+      cairo_set_source_surface (cr, surface->surface, 0, 0);
+    }
+  else
+    {
+      cairo_set_source_surface (cr,
+                                gtk_css_image_surface_get_scaled (surface, width, height, xscale, yscale),
+                                0, 0);
     }
 
-  cairo_rectangle (cr, 0, 0, width, height);
-  cairo_set_source_surface (cr, surface->cache ? surface->cache : surface->surface, 0, 0);
   cairo_fill (cr);
 }
 
@@ -140,7 +193,7 @@ gtk_css_image_surface_dispose (GObject *object)
       surface->surface = NULL;
     }
 
-  g_clear_pointer (&surface->cache, cairo_surface_destroy);
+  _gtk_css_image_render_cache_clear (surface->cache, G_N_ELEMENTS (surface->cache));
 
   G_OBJECT_CLASS (_gtk_css_image_surface_parent_class)->dispose (object);
 }
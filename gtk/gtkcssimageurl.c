@@ -20,6 +20,7 @@
 #include "config.h"
 
 #include <string.h>
+#include <glib/gstdio.h>
 
 #include "gtkcssimageurlprivate.h"
 #include "gtkcssimagesurfaceprivate.h"
@@ -27,6 +28,63 @@
 
 G_DEFINE_TYPE (GtkCssImageUrl, _gtk_css_image_url, GTK_TYPE_CSS_IMAGE)
 
+/* Themes tend to be loaded by several providers (and reloaded on
+ * changes), each parsing its own url() values. Decoded images are
+ * shared between all of them for as long as any of them is alive.
+ * Local files are keyed by their size and modification time too, as
+ * precise as the file system has it, so edited assets are picked up
+ * when the theme is reloaded, even right after they were written.
+ */
+static GHashTable *loaded_images = NULL;
+
+static char *
+gtk_css_image_url_get_cache_key (GFile *file)
+{
+  GStatBuf stat_buf;
+  gint64 mtime_nsec;
+  char *path;
+  char *uri;
+  char *key;
+
+  if (g_file_has_uri_scheme (file, "resource"))
+    return g_file_get_uri (file);
+
+  path = g_file_get_path (file);
+  if (path == NULL)
+    return NULL;
+
+  if (g_stat (path, &stat_buf) != 0)
+    {
+      g_free (path);
+      return NULL;
+    }
+
+#ifdef HAVE_STRUCT_STAT_ST_MTIM
+  mtime_nsec = stat_buf.st_mtim.tv_nsec;
+#else
+  mtime_nsec = 0;
+#endif
+
+  uri = g_file_get_uri (file);
+  key = g_strdup_printf ("%s %" G_GINT64_FORMAT ".%09" G_GINT64_FORMAT " %" G_GINT64_FORMAT,
+                         uri,
+                         (gint64) stat_buf.st_mtime,
+                         mtime_nsec,
+                         (gint64) stat_buf.st_size);
+
+  g_free (uri);
+  g_free (path);
+
+  return key;
+}
+
+static void
+loaded_image_finalized (gpointer  key,
+                        GObject  *image)
+{
+  g_hash_table_remove (loaded_images, key);
+}
+
 static GtkCssImage *
 gtk_css_image_url_load_image (GtkCssImageUrl  *url,
                               GError         **error)
@@ -34,10 +92,24 @@ gtk_css_image_url_load_image (GtkCssImageUrl  *url,
   GdkPixbuf *pixbuf;
   GError *local_error = NULL;
   GFileInputStream *input;
+  char *key;
 
   if (url->loaded_image)
     return url->loaded_image;
 
+  key = gtk_css_image_url_get_cache_key (url->file);
+  if (key != NULL && loaded_images != NULL)
+    {
+      GtkCssImage *image = g_hash_table_lookup (loaded_images, key);
+
+      if (image != NULL)
+        {
+          g_free (key);
+          url->loaded_image = g_object_ref (image);
+          return url->loaded_image;
+        }
+    }
+
   /* We special case resources here so we can use
      gdk_pixbuf_new_from_resource, which in turn has some special casing
      for GdkPixdata files to avoid duplicating the memory for the pixbufs */
@@ -84,12 +156,23 @@ gtk_css_image_url_load_image (GtkCssImageUrl  *url,
       empty = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 0, 0);
       url->loaded_image = _gtk_css_image_surface_new (empty);
       cairo_surface_destroy (empty);
+      g_free (key);
       return url->loaded_image;
     }
 
   url->loaded_image = _gtk_css_image_surface_new_for_pixbuf (pixbuf);
   g_object_unref (pixbuf);
 
+  if (key != NULL)
+    {
+      if (loaded_images == NULL)
+        loaded_images = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+      /* The table owns the key until the image goes away */
+      g_hash_table_insert (loaded_images, key, url->loaded_image);
+      g_object_weak_ref (G_OBJECT (url->loaded_image), loaded_image_finalized, key);
+    }
+
   return url->loaded_image;
 }
 
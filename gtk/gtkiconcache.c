@@ -54,6 +54,12 @@ struct _GtkIconCache {
   gchar *buffer;
 
   guint32 last_chain_offset;
+
+  /* Built on first use, they spare walking the directory list for
+   * every subdirectory and the whole hash for every has_icons check.
+   */
+  GHashTable *directories;
+  guint8 *dirs_with_icons;
 };
 
 GtkIconCache *
@@ -72,6 +78,9 @@ _gtk_icon_cache_unref (GtkIconCache *cache)
     {
       GTK_NOTE (ICONTHEME, g_message ("unmapping icon cache"));
 
+      if (cache->directories)
+        g_hash_table_destroy (cache->directories);
+      g_free (cache->dirs_with_icons);
       if (cache->map)
 	g_mapped_file_unref (cache->map);
       g_free (cache);
@@ -181,26 +190,43 @@ _gtk_icon_cache_new (const gchar *data)
 }
 
 static gint
-get_directory_index (GtkIconCache *cache,
-		     const gchar *directory)
+get_n_directories (GtkIconCache *cache)
 {
   guint32 dir_list_offset;
-  gint n_dirs;
-  gint i;
-  
+
   dir_list_offset = GET_UINT32 (cache->buffer, 8);
 
-  n_dirs = GET_UINT32 (cache->buffer, dir_list_offset);
+  return GET_UINT32 (cache->buffer, dir_list_offset);
+}
 
-  for (i = 0; i < n_dirs; i++)
+static gint
+get_directory_index (GtkIconCache *cache,
+		     const gchar *directory)
+{
+  if (cache->directories == NULL)
     {
-      guint32 name_offset = GET_UINT32 (cache->buffer, dir_list_offset + 4 + 4 * i);
-      gchar *name = cache->buffer + name_offset;
-      if (strcmp (name, directory) == 0)
-	return i;
+      guint32 dir_list_offset;
+      gint n_dirs;
+      gint i;
+
+      dir_list_offset = GET_UINT32 (cache->buffer, 8);
+      n_dirs = get_n_directories (cache);
+
+      /* Keys point into the cache, which outlives the table */
+      cache->directories = g_hash_table_new (g_str_hash, g_str_equal);
+
+      /* Insert backwards so the first of any duplicate names wins */
+      for (i = n_dirs - 1; i >= 0; i--)
+        {
+          guint32 name_offset = GET_UINT32 (cache->buffer, dir_list_offset + 4 + 4 * i);
+
+          g_hash_table_insert (cache->directories,
+                               cache->buffer + name_offset,
+                               GINT_TO_POINTER (i + 1));
+        }
     }
-  
-  return -1;
+
+  return GPOINTER_TO_INT (g_hash_table_lookup (cache->directories, directory)) - 1;
 }
 
 gint
@@ -300,20 +326,21 @@ _gtk_icon_cache_get_icon_flags (GtkIconCache *cache,
   return GET_UINT16 (cache->buffer, image_offset + 2);
 }
 
-gboolean
-_gtk_icon_cache_has_icons (GtkIconCache *cache,
-			   const gchar  *directory)
+static void
+ensure_dirs_with_icons (GtkIconCache *cache)
 {
-  int directory_index;
   guint32 hash_offset, n_buckets;
   guint32 chain_offset;
   guint32 image_list_offset, n_images;
+  guint16 directory_index;
+  gint n_dirs;
   int i, j;
 
-  directory_index = get_directory_index (cache, directory);
+  if (cache->dirs_with_icons != NULL)
+    return;
 
-  if (directory_index == -1)
-    return FALSE;
+  n_dirs = get_n_directories (cache);
+  cache->dirs_with_icons = g_new0 (guint8, MAX (n_dirs, 1));
 
   hash_offset = GET_UINT32 (cache->buffer, 4);
   n_buckets = GET_UINT32 (cache->buffer, hash_offset);
@@ -328,16 +355,30 @@ _gtk_icon_cache_has_icons (GtkIconCache *cache,
 
 	  for (j = 0; j < n_images; j++)
 	    {
-	      if (GET_UINT16 (cache->buffer, image_list_offset + 4 + 8 * j) ==
-		  directory_index)
-		return TRUE;
+	      directory_index = GET_UINT16 (cache->buffer, image_list_offset + 4 + 8 * j);
+	      if (directory_index < n_dirs)
+		cache->dirs_with_icons[directory_index] = TRUE;
 	    }
 
 	  chain_offset = GET_UINT32 (cache->buffer, chain_offset);
 	}
     }
+}
 
-  return FALSE;
+gboolean
+_gtk_icon_cache_has_icons (GtkIconCache *cache,
+			   const gchar  *directory)
+{
+  int directory_index;
+
+  directory_index = get_directory_index (cache, directory);
+
+  if (directory_index == -1)
+    return FALSE;
+
+  ensure_dirs_with_icons (cache);
+
+  return cache->dirs_with_icons[directory_index];
 }
 
 void
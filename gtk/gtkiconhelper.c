@@ -43,18 +43,38 @@ struct _GtkIconHelperPrivate {
   guint use_fallback : 1;
   guint force_scale_pixbuf : 1;
   guint rendered_surface_is_symbolic : 1;
+  guint load_sync : 1;
 
   cairo_surface_t *rendered_surface;
+  GCancellable *cancellable;
+
+  /* What was shown before the last invalidation, drawn instead of
+   * nothing for as long as the new icon is loaded in a thread.
+   */
+  cairo_surface_t *previous_surface;
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (GtkIconHelper, gtk_icon_helper, GTK_TYPE_CSS_GADGET)
 
+static void
+gtk_icon_helper_cancel_load (GtkIconHelper *self)
+{
+  if (self->priv->cancellable != NULL)
+    {
+      g_cancellable_cancel (self->priv->cancellable);
+      g_clear_object (&self->priv->cancellable);
+    }
+}
+
 static void
 gtk_icon_helper_invalidate (GtkIconHelper *self)
 {
+  gtk_icon_helper_cancel_load (self);
+
   if (self->priv->rendered_surface != NULL)
     {
-      cairo_surface_destroy (self->priv->rendered_surface);
+      g_clear_pointer (&self->priv->previous_surface, cairo_surface_destroy);
+      self->priv->previous_surface = self->priv->rendered_surface;
       self->priv->rendered_surface = NULL;
       self->priv->rendered_surface_is_symbolic = FALSE;
     }
@@ -97,12 +117,11 @@ gtk_icon_helper_take_definition (GtkIconHelper      *self,
 void
 _gtk_icon_helper_clear (GtkIconHelper *self)
 {
-  g_clear_pointer (&self->priv->rendered_surface, cairo_surface_destroy);
-
   gtk_image_definition_unref (self->priv->def);
   self->priv->def = gtk_image_definition_new_empty ();
 
   self->priv->icon_size = GTK_ICON_SIZE_INVALID;
+  self->priv->load_sync = FALSE;
 
   gtk_icon_helper_invalidate (self);
 }
@@ -190,6 +209,7 @@ gtk_icon_helper_finalize (GObject *object)
   g_signal_handlers_disconnect_by_func (widget, G_CALLBACK (gtk_icon_helper_invalidate), self);
 
   _gtk_icon_helper_clear (self);
+  g_clear_pointer (&self->priv->previous_surface, cairo_surface_destroy);
   gtk_image_definition_unref (self->priv->def);
   
   G_OBJECT_CLASS (gtk_icon_helper_parent_class)->finalize (object);
@@ -427,20 +447,191 @@ ensure_surface_for_icon_set (GtkIconHelper    *self,
   return surface;
 }
 
+/* Icon theme pixbufs are shared and must not be modified, so
+ * every helper showing the same icon can draw from the same surface
+ * instead of converting the pixbuf into a surface of its own. The
+ * surface keeps the pixbuf alive, and the pixbuf points back at the
+ * surface only for as long as someone is using it.
+ */
+static cairo_user_data_key_t shared_surface_key;
+
+static GQuark
+shared_surface_quark (void)
+{
+  static GQuark quark = 0;
+
+  if (G_UNLIKELY (quark == 0))
+    quark = g_quark_from_static_string ("gtk-icon-helper-shared-surface");
+
+  return quark;
+}
+
+static void
+shared_surface_release_pixbuf (gpointer data)
+{
+  GdkPixbuf *pixbuf = data;
+
+  g_object_set_qdata (G_OBJECT (pixbuf), shared_surface_quark (), NULL);
+  g_object_unref (pixbuf);
+}
+
+static cairo_surface_t *
+get_shared_surface_for_pixbuf (GtkIconHelper *self,
+                               GdkPixbuf     *pixbuf,
+                               gint           scale)
+{
+  cairo_surface_t *surface;
+  double x_scale, y_scale;
+
+  surface = g_object_get_qdata (G_OBJECT (pixbuf), shared_surface_quark ());
+  if (surface != NULL)
+    {
+      cairo_surface_get_device_scale (surface, &x_scale, &y_scale);
+      if (x_scale == scale && y_scale == scale)
+        return cairo_surface_reference (surface);
+
+      return gdk_cairo_surface_create_from_pixbuf (pixbuf, scale, gtk_widget_get_window (gtk_css_gadget_get_owner (GTK_CSS_GADGET (self))));
+    }
+
+  surface = gdk_cairo_surface_create_from_pixbuf (pixbuf, scale, gtk_widget_get_window (gtk_css_gadget_get_owner (GTK_CSS_GADGET (self))));
+  cairo_surface_set_user_data (surface, &shared_surface_key,
+                               g_object_ref (pixbuf),
+                               shared_surface_release_pixbuf);
+  g_object_set_qdata (G_OBJECT (pixbuf), shared_surface_quark (), surface);
+
+  return surface;
+}
+
+static cairo_surface_t *
+surface_for_icon_pixbuf (GtkIconHelper *self,
+                         GtkCssStyle   *style,
+                         gint           scale,
+                         GdkPixbuf     *pixbuf,
+                         gboolean       symbolic)
+{
+  cairo_surface_t *surface;
+
+  if (!symbolic)
+    {
+      GtkCssIconEffect icon_effect;
+
+      icon_effect = _gtk_css_icon_effect_value_get (gtk_css_style_get_value (style, GTK_CSS_PROPERTY_ICON_EFFECT));
+      if (icon_effect == GTK_CSS_ICON_EFFECT_NONE)
+        surface = get_shared_surface_for_pixbuf (self, pixbuf, scale);
+      else
+        {
+          /* The effect is applied in place, so this needs its own copy */
+          surface = gdk_cairo_surface_create_from_pixbuf (pixbuf, scale, gtk_widget_get_window (gtk_css_gadget_get_owner (GTK_CSS_GADGET (self))));
+          gtk_css_icon_effect_apply (icon_effect, surface);
+        }
+    }
+  else
+    {
+      surface = get_shared_surface_for_pixbuf (self, pixbuf, scale);
+      self->priv->rendered_surface_is_symbolic = TRUE;
+    }
+
+  return surface;
+}
+
+static void
+icon_loaded_cb (GObject      *source,
+                GAsyncResult *result,
+                gpointer      data)
+{
+  GtkIconInfo *info = GTK_ICON_INFO (source);
+  GtkIconHelper *self;
+  GtkWidget *owner;
+  GdkPixbuf *pixbuf;
+  gboolean symbolic;
+  gint old_width, old_height;
+  gint width, height;
+  GError *error = NULL;
+
+  symbolic = gtk_icon_info_is_symbolic (info);
+  if (symbolic)
+    pixbuf = gtk_icon_info_load_symbolic_finish (info, result, NULL, &error);
+  else
+    pixbuf = gtk_icon_info_load_icon_finish (info, result, &error);
+
+  /* The helper may be gone already if the load was cancelled */
+  if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+      g_error_free (error);
+      return;
+    }
+
+  self = data;
+  owner = gtk_css_gadget_get_owner (GTK_CSS_GADGET (self));
+  g_clear_object (&self->priv->cancellable);
+  g_clear_pointer (&self->priv->previous_surface, cairo_surface_destroy);
+
+  if (pixbuf == NULL)
+    {
+      /* Let the synchronous path deal with the fallback icon */
+      g_error_free (error);
+      self->priv->load_sync = TRUE;
+      gtk_widget_queue_resize (owner);
+      return;
+    }
+
+  ensure_icon_size (self, &old_width, &old_height);
+
+  self->priv->rendered_surface =
+    surface_for_icon_pixbuf (self,
+                             gtk_css_node_get_style (gtk_css_gadget_get_node (GTK_CSS_GADGET (self))),
+                             gtk_widget_get_scale_factor (owner),
+                             pixbuf,
+                             symbolic);
+  g_object_unref (pixbuf);
+
+  /* Until now the icon was sized from its nominal size; only relayout
+   * if the loaded icon turned out different.
+   */
+  get_surface_size (self, self->priv->rendered_surface, &width, &height);
+  if (width != old_width || height != old_height)
+    gtk_widget_queue_resize (owner);
+  else
+    gtk_widget_queue_draw (owner);
+}
+
+static gboolean
+should_load_async (GtkIconHelper *self,
+                   GtkIconInfo   *info,
+                   const GdkRGBA *fg,
+                   const GdkRGBA *success_color,
+                   const GdkRGBA *warning_color,
+                   const GdkRGBA *error_color)
+{
+  GtkCssGadget *gadget = GTK_CSS_GADGET (self);
+
+  /* Icons are loaded in a thread only when showing them late is
+   * harmless: the widget is already on screen, the helper is not a
+   * transient one that is gone after a single draw, and loading would
+   * mean reading or rendering an image.
+   */
+  return !self->priv->load_sync &&
+         (self->priv->icon_size != GTK_ICON_SIZE_INVALID || self->priv->pixel_size != -1) &&
+         gtk_widget_get_mapped (gtk_css_gadget_get_owner (gadget)) &&
+         !GTK_IS_CSS_TRANSIENT_NODE (gtk_css_gadget_get_node (gadget)) &&
+         !gtk_icon_info_is_loaded (info, fg, success_color, warning_color, error_color);
+}
+
 static cairo_surface_t *
 ensure_surface_for_gicon (GtkIconHelper    *self,
                           GtkCssStyle      *style,
                           GtkTextDirection  dir,
                           gint              scale,
-                          GIcon            *gicon)
+                          GIcon            *gicon,
+                          gboolean          allow_async)
 {
-  GtkIconHelperPrivate *priv = self->priv;
   GtkIconTheme *icon_theme;
   gint width, height;
   GtkIconInfo *info;
   GtkIconLookupFlags flags;
   cairo_surface_t *surface;
   GdkPixbuf *destination;
+  GdkRGBA fg, success_color, warning_color, error_color;
   gboolean symbolic;
 
   icon_theme = gtk_css_icon_theme_value_get_icon_theme
@@ -453,16 +644,44 @@ ensure_surface_for_gicon (GtkIconHelper    *self,
                                                    gicon,
                                                    MIN (width, height),
                                                    scale, flags);
-  if (info)
+
+  symbolic = info && gtk_icon_info_is_symbolic (info);
+  if (symbolic)
+    gtk_icon_theme_lookup_symbolic_colors (style, &fg, &success_color, &warning_color, &error_color);
+
+  if (info && allow_async &&
+      should_load_async (self, info,
+                         symbolic ? &fg : NULL, &success_color,
+                         &warning_color, &error_color))
     {
-      symbolic = gtk_icon_info_is_symbolic (info);
+      self->priv->cancellable = g_cancellable_new ();
 
       if (symbolic)
         {
-          GdkRGBA fg, success_color, warning_color, error_color;
+          gtk_icon_info_load_symbolic_async (info,
+                                             &fg, &success_color,
+                                             &warning_color, &error_color,
+                                             self->priv->cancellable,
+                                             icon_loaded_cb,
+                                             self);
+        }
+      else
+        {
+          gtk_icon_info_load_icon_async (info,
+                                         self->priv->cancellable,
+                                         icon_loaded_cb,
+                                         self);
+        }
+
+      g_object_unref (info);
 
-          gtk_icon_theme_lookup_symbolic_colors (style, &fg, &success_color, &warning_color, &error_color);
+      return NULL;
+    }
 
+  if (info)
+    {
+      if (symbolic)
+        {
           destination = gtk_icon_info_load_symbolic (info,
                                                      &fg, &success_color,
                                                      &warning_color, &error_color,
@@ -497,28 +716,17 @@ ensure_surface_for_gicon (GtkIconHelper    *self,
       symbolic = FALSE;
     }
 
-  surface = gdk_cairo_surface_create_from_pixbuf (destination, scale, gtk_widget_get_window (gtk_css_gadget_get_owner (GTK_CSS_GADGET (self))));
-
-  if (!symbolic)
-    {
-      GtkCssIconEffect icon_effect;
-
-      icon_effect = _gtk_css_icon_effect_value_get (gtk_css_style_get_value (style, GTK_CSS_PROPERTY_ICON_EFFECT));
-      gtk_css_icon_effect_apply (icon_effect, surface);
-    }
-  else
-    {
-      priv->rendered_surface_is_symbolic = TRUE;
-    }
+  surface = surface_for_icon_pixbuf (self, style, scale, destination, symbolic);
 
   g_object_unref (destination);
 
   return surface;
 }
 
-cairo_surface_t *
-gtk_icon_helper_load_surface (GtkIconHelper   *self,
-                              int              scale)
+static cairo_surface_t *
+gtk_icon_helper_load_surface_internal (GtkIconHelper *self,
+                                       int            scale,
+                                       gboolean       allow_async)
 {
   cairo_surface_t *surface;
   GtkIconSet *icon_set;
@@ -568,7 +776,8 @@ G_GNUC_END_IGNORE_DEPRECATIONS;
                                           gtk_css_node_get_style (gtk_css_gadget_get_node (GTK_CSS_GADGET (self))),
                                           gtk_widget_get_direction (gtk_css_gadget_get_owner (GTK_CSS_GADGET (self))), 
                                           scale, 
-                                          gicon);
+                                          gicon,
+                                          allow_async);
       g_object_unref (gicon);
       break;
 
@@ -577,7 +786,8 @@ G_GNUC_END_IGNORE_DEPRECATIONS;
                                           gtk_css_node_get_style (gtk_css_gadget_get_node (GTK_CSS_GADGET (self))),
                                           gtk_widget_get_direction (gtk_css_gadget_get_owner (GTK_CSS_GADGET (self))), 
                                           scale,
-                                          gtk_image_definition_get_gicon (self->priv->def));
+                                          gtk_image_definition_get_gicon (self->priv->def),
+                                          allow_async);
       break;
 
     case GTK_IMAGE_ANIMATION:
@@ -591,17 +801,27 @@ G_GNUC_END_IGNORE_DEPRECATIONS;
 
 }
 
+cairo_surface_t *
+gtk_icon_helper_load_surface (GtkIconHelper   *self,
+                              int              scale)
+{
+  return gtk_icon_helper_load_surface_internal (self, scale, FALSE);
+}
+
 static void
 gtk_icon_helper_ensure_surface (GtkIconHelper *self)
 {
   int scale;
 
-  if (self->priv->rendered_surface)
+  if (self->priv->rendered_surface || self->priv->cancellable)
     return;
 
   scale = gtk_widget_get_scale_factor (gtk_css_gadget_get_owner (GTK_CSS_GADGET (self)));
 
-  self->priv->rendered_surface = gtk_icon_helper_load_surface (self, scale);
+  self->priv->rendered_surface = gtk_icon_helper_load_surface_internal (self, scale, TRUE);
+
+  if (self->priv->cancellable == NULL)
+    g_clear_pointer (&self->priv->previous_surface, cairo_surface_destroy);
 }
 
 void
@@ -896,13 +1116,19 @@ _gtk_icon_helper_draw (GtkIconHelper *self,
                        gdouble y)
 {
   GtkCssStyle *style = gtk_css_node_get_style (gtk_css_gadget_get_node (GTK_CSS_GADGET (self)));
+  cairo_surface_t *surface;
+
   gtk_icon_helper_ensure_surface (self);
 
-  if (self->priv->rendered_surface != NULL)
+  surface = self->priv->rendered_surface;
+  if (surface == NULL && self->priv->cancellable != NULL)
+    surface = self->priv->previous_surface;
+
+  if (surface != NULL)
     {
       gtk_css_style_render_icon_surface (style,
                                          cr,
-                                         self->priv->rendered_surface,
+                                         surface,
                                          x, y);
     }
 }
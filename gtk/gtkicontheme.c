@@ -269,6 +269,12 @@ struct _GtkIconInfo
 
   SymbolicPixbufCache *symbolic_pixbuf_cache;
 
+  /* Symbolic SVGs are rendered with the colors of the first load;
+   * any further colors are applied to the encoded symbolic_pixbuf.
+   */
+  GdkPixbuf *symbolic_pixbuf;
+  guint symbolic_rendered : 1;
+
   gint symbolic_width;
   gint symbolic_height;
 };
@@ -1160,6 +1166,8 @@ insert_theme (GtkIconTheme *icon_theme,
       if (g_stat (path, &stat_buf) == 0 && S_ISDIR (stat_buf.st_mode)) {
         dir_mtime->mtime = stat_buf.st_mtime;
         dir_mtime->exists = TRUE;
+        /* This will return NULL if the cache doesn't exist or is outdated */
+        dir_mtime->cache = _gtk_icon_cache_new_for_path (path);
       } else {
         dir_mtime->mtime = 0;
         dir_mtime->exists = FALSE;
@@ -3370,49 +3378,46 @@ theme_subdir_load (GtkIconTheme *icon_theme,
       if (!dir_mtime->exists)
         continue; /* directory doesn't exist */
 
-      full_dir = g_build_filename (dir_mtime->dir, subdir, NULL);
-
-      /* First, see if we have a cache for the directory */
-      if (dir_mtime->cache != NULL || g_file_test (full_dir, G_FILE_TEST_IS_DIR))
-        {
-          if (dir_mtime->cache == NULL)
-            {
-              /* This will return NULL if the cache doesn't exist or is outdated */
-              dir_mtime->cache = _gtk_icon_cache_new_for_path (dir_mtime->dir);
-            }
+      /* The cache for the theme directory was looked for when the
+       * theme was inserted. Without one, scan_directory() fails for
+       * subdirectories that don't exist, so there is no need to stat
+       * each of them first.
+       */
+      if (dir_mtime->cache != NULL &&
+          !_gtk_icon_cache_has_icons (dir_mtime->cache, subdir))
+        continue;
 
-          dir = g_new0 (IconThemeDir, 1);
-          dir->type = type;
-          dir->is_resource = FALSE;
-          dir->context = context;
-          dir->size = size;
-          dir->min_size = min_size;
-          dir->max_size = max_size;
-          dir->threshold = threshold;
-          dir->dir = full_dir;
-          dir->subdir = g_strdup (subdir);
-          dir->scale = scale;
+      full_dir = g_build_filename (dir_mtime->dir, subdir, NULL);
 
-          if (dir_mtime->cache != NULL)
-            {
-              dir->cache = _gtk_icon_cache_ref (dir_mtime->cache);
-              dir->subdir_index = _gtk_icon_cache_get_directory_index (dir->cache, dir->subdir);
-              has_icons = _gtk_icon_cache_has_icons (dir->cache, dir->subdir);
-            }
-          else
-            {
-              dir->cache = NULL;
-              dir->subdir_index = -1;
-              has_icons = scan_directory (icon_theme->priv, dir, full_dir);
-            }
+      dir = g_new0 (IconThemeDir, 1);
+      dir->type = type;
+      dir->is_resource = FALSE;
+      dir->context = context;
+      dir->size = size;
+      dir->min_size = min_size;
+      dir->max_size = max_size;
+      dir->threshold = threshold;
+      dir->dir = full_dir;
+      dir->subdir = g_strdup (subdir);
+      dir->scale = scale;
 
-          if (has_icons)
-            theme->dirs = g_list_prepend (theme->dirs, dir);
-          else
-            theme_dir_destroy (dir);
+      if (dir_mtime->cache != NULL)
+        {
+          dir->cache = _gtk_icon_cache_ref (dir_mtime->cache);
+          dir->subdir_index = _gtk_icon_cache_get_directory_index (dir->cache, dir->subdir);
+          has_icons = TRUE;
         }
       else
-        g_free (full_dir);
+        {
+          dir->cache = NULL;
+          dir->subdir_index = -1;
+          has_icons = scan_directory (icon_theme->priv, dir, full_dir);
+        }
+
+      if (has_icons)
+        theme->dirs = g_list_prepend (theme->dirs, dir);
+      else
+        theme_dir_destroy (dir);
     }
 
   if (strcmp (theme->name, FALLBACK_ICON_THEME) == 0)
@@ -3508,6 +3513,9 @@ icon_info_dup (GtkIconInfo *icon_info)
 
   if (icon_info->cache_pixbuf)
     dup->cache_pixbuf = g_object_ref (icon_info->cache_pixbuf);
+  if (icon_info->symbolic_pixbuf)
+    dup->symbolic_pixbuf = g_object_ref (icon_info->symbolic_pixbuf);
+  dup->symbolic_rendered = icon_info->symbolic_rendered;
 
   dup->scale = icon_info->scale;
   dup->unscaled_scale = icon_info->unscaled_scale;
@@ -3591,6 +3599,7 @@ gtk_icon_info_finalize (GObject *object)
   g_clear_error (&icon_info->load_error);
 
   symbolic_pixbuf_cache_free (icon_info->symbolic_pixbuf_cache);
+  g_clear_object (&icon_info->symbolic_pixbuf);
 
   G_OBJECT_CLASS (gtk_icon_info_parent_class)->finalize (object);
 }
@@ -3846,6 +3855,395 @@ icon_info_get_pixbuf_ready (GtkIconInfo *icon_info)
   return FALSE;
 }
 
+/* Rasterizing SVG icons is by far the most expensive part of
+ * loading them, and every process does it again for the same
+ * icons. Rendered SVG icons are therefore kept in the user cache
+ * directory as raw pixel data that is mapped straight into a pixbuf.
+ * The file name is a checksum over the source file's path, modification
+ * time and size together with the size the icon was rendered at and
+ * the loaders that rendered it, so changed or replaced icons and
+ * upgraded loaders simply miss the cache.
+ *
+ * Entries that are left behind that way are never looked at again, so
+ * the directory is pruned back below RENDERED_ICON_CACHE_SIZE, dropping
+ * the entries that were least recently used first. Pruning has to look
+ * at every entry, so it is done in a thread.
+ */
+#define RENDERED_ICON_MAGIC   0x4e434947 /* "GICN" */
+#define RENDERED_ICON_VERSION 1
+
+#define RENDERED_ICON_CACHE_SIZE (32 * 1024 * 1024)
+
+typedef struct
+{
+  guint32 magic;
+  guint32 version;
+  guint32 width;
+  guint32 height;
+  guint32 rowstride;
+  guint32 has_alpha;
+} RenderedIconHeader;
+
+G_LOCK_DEFINE_STATIC (rendered_icon_cache);
+static gsize rendered_icon_cache_written = RENDERED_ICON_CACHE_SIZE;
+static gboolean rendered_icon_cache_pruning = FALSE;
+
+typedef struct
+{
+  gchar *name;
+  gint64 size;
+  gint64 used;
+} RenderedIconEntry;
+
+static gint
+rendered_icon_entry_compare (gconstpointer a,
+                             gconstpointer b)
+{
+  const RenderedIconEntry *entry_a = a;
+  const RenderedIconEntry *entry_b = b;
+
+  if (entry_a->used < entry_b->used)
+    return -1;
+  else if (entry_a->used > entry_b->used)
+    return 1;
+
+  return 0;
+}
+
+static void
+rendered_icon_cache_prune (const gchar *dir)
+{
+  GDir *gdir;
+  GArray *entries;
+  const gchar *name;
+  gint64 total;
+  guint i;
+
+  gdir = g_dir_open (dir, 0, NULL);
+  if (gdir == NULL)
+    return;
+
+  entries = g_array_new (FALSE, FALSE, sizeof (RenderedIconEntry));
+  total = 0;
+
+  while ((name = g_dir_read_name (gdir)) != NULL)
+    {
+      RenderedIconEntry entry;
+      GStatBuf st;
+      gchar *path;
+
+      path = g_build_filename (dir, name, NULL);
+      if (g_stat (path, &st) == 0 && !S_ISDIR (st.st_mode))
+        {
+          entry.name = g_strdup (name);
+          entry.size = st.st_size;
+          /* Loading an entry maps it, which updates its access time
+           * unless the file system is mounted with noatime; fall back
+           * to the time it was written in that case.
+           */
+          entry.used = MAX (st.st_atime, st.st_mtime);
+          g_array_append_val (entries, entry);
+          total += entry.size;
+        }
+      g_free (path);
+    }
+
+  g_dir_close (gdir);
+
+  if (total > RENDERED_ICON_CACHE_SIZE)
+    {
+      g_array_sort (entries, rendered_icon_entry_compare);
+
+      /* Leave some room, so that pruning doesn't start over with
+       * the next icon that gets stored.
+       */
+      for (i = 0; i < entries->len && total > RENDERED_ICON_CACHE_SIZE / 4 * 3; i++)
+        {
+          RenderedIconEntry *entry = &g_array_index (entries, RenderedIconEntry, i);
+          gchar *path;
+
+          path = g_build_filename (dir, entry->name, NULL);
+          if (g_unlink (path) == 0)
+            total -= entry->size;
+          g_free (path);
+        }
+
+      GTK_NOTE (ICONTHEME, g_message ("pruned rendered icon cache %s to %" G_GINT64_FORMAT " bytes", dir, total));
+    }
+
+  for (i = 0; i < entries->len; i++)
+    g_free (g_array_index (entries, RenderedIconEntry, i).name);
+  g_array_free (entries, TRUE);
+}
+
+static void
+rendered_icon_cache_prune_thread (GTask        *task,
+                                  gpointer      source_object,
+                                  gpointer      task_data,
+                                  GCancellable *cancellable)
+{
+  rendered_icon_cache_prune (task_data);
+
+  G_LOCK (rendered_icon_cache);
+  rendered_icon_cache_pruning = FALSE;
+  G_UNLOCK (rendered_icon_cache);
+
+  g_task_return_boolean (task, TRUE);
+}
+
+/* Renderings of the same file change with the loaders, so they are
+ * part of the cache key. The version of the SVG loader itself is not
+ * known, its format description is the best there is.
+ */
+static const gchar *
+rendered_icon_cache_renderer (void)
+{
+  static gchar *renderer = NULL;
+
+  if (g_once_init_enter (&renderer))
+    {
+      GString *string;
+      GSList *formats, *l;
+
+      string = g_string_new ("gdk-pixbuf ");
+      g_string_append (string, gdk_pixbuf_version);
+
+      formats = gdk_pixbuf_get_formats ();
+      for (l = formats; l; l = l->next)
+        {
+          GdkPixbufFormat *format = l->data;
+          gchar *name, *description, *license;
+
+          name = gdk_pixbuf_format_get_name (format);
+          if (g_str_equal (name, "svg"))
+            {
+              description = gdk_pixbuf_format_get_description (format);
+              license = gdk_pixbuf_format_get_license (format);
+              g_string_append_printf (string, "\n%s %s %s", name, description, license);
+              g_free (description);
+              g_free (license);
+            }
+          g_free (name);
+        }
+      g_slist_free (formats);
+
+      g_once_init_leave (&renderer, g_string_free (string, FALSE));
+    }
+
+  return renderer;
+}
+
+static gchar *
+rendered_icon_cache_file (GtkIconInfo *icon_info,
+                          gint         size,
+                          const gchar *variant)
+{
+  GStatBuf st;
+  gint64 mtime_nsec;
+  gchar *path;
+  gchar *key;
+  gchar *checksum;
+  gchar *result;
+
+  if (icon_info->icon_file == NULL)
+    return NULL;
+
+  path = g_file_get_path (icon_info->icon_file);
+  if (path == NULL)
+    return NULL;
+
+  if (g_stat (path, &st) != 0)
+    {
+      g_free (path);
+      return NULL;
+    }
+
+#ifdef HAVE_STRUCT_STAT_ST_MTIM
+  mtime_nsec = st.st_mtim.tv_nsec;
+#else
+  mtime_nsec = 0;
+#endif
+
+  key = g_strdup_printf ("%s\n%s\n%" G_GINT64_FORMAT ".%09" G_GINT64_FORMAT "\n%" G_GINT64_FORMAT "\n%d\n%d%s%s",
+                         rendered_icon_cache_renderer (),
+                         path,
+                         (gint64) st.st_mtime,
+                         mtime_nsec,
+                         (gint64) st.st_size,
+                         size,
+                         icon_info->desired_scale,
+                         variant ? "\n" : "",
+                         variant ? variant : "");
+  checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, key, -1);
+  result = g_build_filename (g_get_user_cache_dir (), "gtk-3.0", "icons", checksum, NULL);
+
+  g_free (checksum);
+  g_free (key);
+  g_free (path);
+
+  return result;
+}
+
+static void
+rendered_icon_unmap (guchar   *pixels,
+                     gpointer  data)
+{
+  g_mapped_file_unref (data);
+}
+
+static GdkPixbuf *
+rendered_icon_load (const gchar *cache_file)
+{
+  GMappedFile *map;
+  RenderedIconHeader header;
+  const gchar *contents;
+  gsize length;
+  gsize needed;
+  gint n_channels;
+
+  /* A writable mapping is private to this process, so callers
+   * modifying the pixbuf never touch the file.
+   */
+  map = g_mapped_file_new (cache_file, TRUE, NULL);
+  if (map == NULL)
+    return NULL;
+
+  contents = g_mapped_file_get_contents (map);
+  length = g_mapped_file_get_length (map);
+
+  if (length < sizeof (RenderedIconHeader))
+    goto invalid;
+
+  memcpy (&header, contents, sizeof (RenderedIconHeader));
+  if (header.magic != RENDERED_ICON_MAGIC ||
+      header.version != RENDERED_ICON_VERSION ||
+      header.width == 0 || header.height == 0 ||
+      header.width > G_MAXINT / 4)
+    goto invalid;
+
+  n_channels = header.has_alpha ? 4 : 3;
+  if (header.rowstride < header.width * n_channels ||
+      header.rowstride > G_MAXINT ||
+      header.height > G_MAXINT / header.rowstride)
+    goto invalid;
+
+  needed = sizeof (RenderedIconHeader) +
+           (gsize) header.rowstride * (header.height - 1) +
+           (gsize) header.width * n_channels;
+  if (length < needed)
+    goto invalid;
+
+  return gdk_pixbuf_new_from_data ((guchar *) contents + sizeof (RenderedIconHeader),
+                                   GDK_COLORSPACE_RGB,
+                                   header.has_alpha,
+                                   8,
+                                   header.width,
+                                   header.height,
+                                   header.rowstride,
+                                   rendered_icon_unmap,
+                                   map);
+
+invalid:
+  g_mapped_file_unref (map);
+  return NULL;
+}
+
+static void
+rendered_icon_store (const gchar *cache_file,
+                     GdkPixbuf   *pixbuf)
+{
+  RenderedIconHeader header;
+  gchar *dir;
+  gchar *data;
+  gsize pixels_length;
+
+  if (gdk_pixbuf_get_colorspace (pixbuf) != GDK_COLORSPACE_RGB ||
+      gdk_pixbuf_get_bits_per_sample (pixbuf) != 8)
+    return;
+
+  dir = g_path_get_dirname (cache_file);
+  if (g_mkdir_with_parents (dir, 0700) != 0)
+    {
+      g_free (dir);
+      return;
+    }
+  g_free (dir);
+
+  header.magic = RENDERED_ICON_MAGIC;
+  header.version = RENDERED_ICON_VERSION;
+  header.width = gdk_pixbuf_get_width (pixbuf);
+  header.height = gdk_pixbuf_get_height (pixbuf);
+  header.rowstride = gdk_pixbuf_get_rowstride (pixbuf);
+  header.has_alpha = gdk_pixbuf_get_has_alpha (pixbuf);
+
+  pixels_length = gdk_pixbuf_get_byte_length (pixbuf);
+  data = g_malloc (sizeof (RenderedIconHeader) + pixels_length);
+  memcpy (data, &header, sizeof (RenderedIconHeader));
+  memcpy (data + sizeof (RenderedIconHeader),
+          gdk_pixbuf_get_pixels (pixbuf),
+          pixels_length);
+
+  /* g_file_set_contents() writes to a temporary file and renames it,
+   * so concurrent readers only ever see complete entries.
+   */
+  if (!g_file_set_contents (cache_file, data,
+                            sizeof (RenderedIconHeader) + pixels_length, NULL))
+    GTK_NOTE (ICONTHEME, g_message ("could not write rendered icon cache %s", cache_file));
+
+  g_free (data);
+
+  /* Prune when a process first adds to the cache and after every
+   * quarter of the cache size that it wrote since then. This may
+   * run in a loader thread, the pruning itself always runs in one
+   * of its own.
+   */
+  G_LOCK (rendered_icon_cache);
+  rendered_icon_cache_written += sizeof (RenderedIconHeader) + pixels_length;
+  if (rendered_icon_cache_written >= RENDERED_ICON_CACHE_SIZE / 4 &&
+      !rendered_icon_cache_pruning)
+    {
+      GTask *task;
+
+      rendered_icon_cache_written = 0;
+      rendered_icon_cache_pruning = TRUE;
+
+      task = g_task_new (NULL, NULL, NULL, NULL);
+      g_task_set_source_tag (task, rendered_icon_cache_prune_thread);
+      g_task_set_task_data (task, g_path_get_dirname (cache_file), g_free);
+      g_task_run_in_thread (task, rendered_icon_cache_prune_thread);
+      g_object_unref (task);
+    }
+  G_UNLOCK (rendered_icon_cache);
+}
+
+/* Whether loading @icon_info can be done without going to disk
+ * or rendering, so that callers can decide to load it asynchronously
+ * otherwise. Symbolic icons are loaded with the given colors, @fg is
+ * %NULL for loading them as regular icons.
+ */
+gboolean
+gtk_icon_info_is_loaded (GtkIconInfo   *icon_info,
+                         const GdkRGBA *fg,
+                         const GdkRGBA *success_color,
+                         const GdkRGBA *warning_color,
+                         const GdkRGBA *error_color)
+{
+  if (icon_info->cache_pixbuf)
+    return TRUE;
+
+  if (fg && gtk_icon_info_is_symbolic (icon_info))
+    {
+      if (symbolic_pixbuf_cache_matches (icon_info->symbolic_pixbuf_cache,
+                                         fg, success_color, warning_color, error_color))
+        return TRUE;
+
+      if (icon_info->is_svg)
+        return icon_info->symbolic_pixbuf != NULL;
+    }
+
+  return icon_info_get_pixbuf_ready (icon_info);
+}
+
 /* This function contains the complicated logic for deciding
  * on the size at which to load the icon and loading it at
  * that size.
@@ -3936,25 +4334,36 @@ icon_info_ensure_scale_and_pixbuf (GtkIconInfo *icon_info)
   else
     {
       GInputStream *stream;
+      gchar *cache_file = NULL;
+      gint size = 0;
+
+      /* SVG icons are a special case - we just immediately scale them
+       * to the desired size
+       */
+      if (icon_info->is_svg)
+        {
+          if (icon_info->forced_size || icon_info->dir_type == ICON_THEME_DIR_UNTHEMED)
+            size = scaled_desired_size;
+          else
+            size = icon_info->dir_size * dir_scale * icon_info->scale;
+
+          cache_file = rendered_icon_cache_file (icon_info, size, NULL);
+          if (cache_file)
+            source_pixbuf = rendered_icon_load (cache_file);
+        }
 
       /* TODO: We should have a load_at_scale */
-      stream = g_loadable_icon_load (icon_info->loadable,
-                                     scaled_desired_size,
-                                     NULL, NULL,
-                                     &icon_info->load_error);
+      if (source_pixbuf)
+        stream = NULL;
+      else
+        stream = g_loadable_icon_load (icon_info->loadable,
+                                       scaled_desired_size,
+                                       NULL, NULL,
+                                       &icon_info->load_error);
       if (stream)
         {
-          /* SVG icons are a special case - we just immediately scale them
-           * to the desired size
-           */
           if (icon_info->is_svg)
             {
-              gint size;
-
-              if (icon_info->forced_size || icon_info->dir_type == ICON_THEME_DIR_UNTHEMED)
-                size = scaled_desired_size;
-              else
-                size = icon_info->dir_size * dir_scale * icon_info->scale;
               if (size == 0)
                 source_pixbuf = _gdk_pixbuf_new_from_stream_scaled (stream,
                                                                     icon_info->desired_scale,
@@ -3965,6 +4374,9 @@ icon_info_ensure_scale_and_pixbuf (GtkIconInfo *icon_info)
                                                                      size, size,
                                                                      TRUE, NULL,
                                                                      &icon_info->load_error);
+
+              if (source_pixbuf && cache_file)
+                rendered_icon_store (cache_file, source_pixbuf);
             }
           else
             source_pixbuf = gdk_pixbuf_new_from_stream (stream,
@@ -3972,6 +4384,8 @@ icon_info_ensure_scale_and_pixbuf (GtkIconInfo *icon_info)
                                                         &icon_info->load_error);
           g_object_unref (stream);
         }
+
+      g_free (cache_file);
     }
 
   if (!source_pixbuf)
@@ -4335,17 +4749,6 @@ symbolic_cache_get_proxy (SymbolicPixbufCache *symbolic_cache,
   return symbolic_cache->proxy_pixbuf;
 }
 
-static gchar *
-rgba_to_string_noalpha (const GdkRGBA *rgba)
-{
-  GdkRGBA color;
-
-  color = *rgba;
-  color.alpha = 1.0;
-
-  return gdk_rgba_to_string (&color);
-}
-
 static void
 rgba_to_pixel(const GdkRGBA  *rgba,
 	      guint8 pixel[4])
@@ -4478,79 +4881,32 @@ gtk_icon_info_load_symbolic_png (GtkIconInfo    *icon_info,
                                                error_color ? error_color : &error_default);
 }
 
-static GdkPixbuf *
-gtk_icon_info_load_symbolic_svg (GtkIconInfo    *icon_info,
-                                 const GdkRGBA  *fg,
-                                 const GdkRGBA  *success_color,
-                                 const GdkRGBA  *warning_color,
-                                 const GdkRGBA  *error_color,
-                                 GError        **error)
+/* Loads the symbolic SVG and makes sure the size it was drawn at is
+ * known. The size it gets rendered at is that of icon_info->pixbuf.
+ */
+static gchar *
+icon_info_load_symbolic_file (GtkIconInfo  *icon_info,
+                              gsize        *file_len,
+                              GError      **error)
 {
   GInputStream *stream;
   GdkPixbuf *pixbuf;
-  gchar *css_fg;
-  gchar *css_success;
-  gchar *css_warning;
-  gchar *css_error;
-  gchar *data;
-  gchar *width;
-  gchar *height;
-  gchar *file_data, *escaped_file_data;
-  gsize file_len;
+  gchar *file_data;
   gint symbolic_size;
-  double alpha;
-  gchar alphastr[G_ASCII_DTOSTR_BUF_SIZE];
-
-  alpha = fg->alpha;
-
-  css_fg = rgba_to_string_noalpha (fg);
-
-  css_success = css_warning = css_error = NULL;
-
-  if (warning_color)
-    css_warning = rgba_to_string_noalpha (warning_color);
-  else
-    css_warning = g_strdup ("rgb(245,121,62)");
-
-  if (error_color)
-    css_error = rgba_to_string_noalpha (error_color);
-  else
-    css_error = g_strdup ("rgb(204,0,0)");
 
-  if (success_color)
-    css_success = rgba_to_string_noalpha (success_color);
-  else
-    css_success = g_strdup ("rgb(78,154,6)");
-
-  if (!g_file_load_contents (icon_info->icon_file, NULL, &file_data, &file_len, NULL, error))
+  if (!g_file_load_contents (icon_info->icon_file, NULL, &file_data, file_len, NULL, error))
     return NULL;
 
-  if (!icon_info_ensure_scale_and_pixbuf (icon_info))
-    {
-      g_propagate_error (error, icon_info->load_error);
-      icon_info->load_error = NULL;
-      g_free (css_fg);
-      g_free (css_warning);
-      g_free (css_error);
-      g_free (css_success);
-      g_free (file_data);
-      return NULL;
-    }
-
   if (icon_info->symbolic_width == 0 ||
       icon_info->symbolic_height == 0)
     {
       /* Fetch size from the original icon */
-      stream = g_memory_input_stream_new_from_data (file_data, file_len, NULL);
+      stream = g_memory_input_stream_new_from_data (file_data, *file_len, NULL);
       pixbuf = gdk_pixbuf_new_from_stream (stream, NULL, error);
       g_object_unref (stream);
 
       if (!pixbuf)
         {
-          g_free (css_fg);
-          g_free (css_warning);
-          g_free (css_error);
-          g_free (css_success);
           g_free (file_data);
           return NULL;
         }
@@ -4573,55 +4929,113 @@ gtk_icon_info_load_symbolic_svg (GtkIconInfo    *icon_info,
                icon_info->dir_size * icon_info->dir_scale)
   );
 
-  width = g_strdup_printf ("%d", icon_info->symbolic_width);
-  height = g_strdup_printf ("%d", icon_info->symbolic_height);
-
-  escaped_file_data = g_base64_encode ((guchar *) file_data, file_len);
-  g_free (file_data);
-
-  g_ascii_dtostr (alphastr, G_ASCII_DTOSTR_BUF_SIZE, CLAMP (alpha, 0, 1));
-
-  data = g_strconcat ("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n"
-                      "<svg version=\"1.1\"\n"
-                      "     xmlns=\"http://www.w3.org/2000/svg\"\n"
-                      "     xmlns:xi=\"http://www.w3.org/2001/XInclude\"\n"
-                      "     width=\"", width, "\"\n"
-                      "     height=\"", height, "\">\n"
-                      "  <style type=\"text/css\">\n"
-                      "    rect,path,ellipse,circle,polygon {\n"
-                      "      fill: ", css_fg," !important;\n"
-                      "    }\n"
-                      "    .warning {\n"
-                      "      fill: ", css_warning, " !important;\n"
-                      "    }\n"
-                      "    .error {\n"
-                      "      fill: ", css_error ," !important;\n"
-                      "    }\n"
-                      "    .success {\n"
-                      "      fill: ", css_success, " !important;\n"
-                      "    }\n"
-                      "  </style>\n"
-                      "  <g opacity=\"", alphastr, "\" ><xi:include href=\"data:text/xml;base64,", escaped_file_data, "\"/></g>\n"
-                      "</svg>",
-                      NULL);
-  g_free (escaped_file_data);
-  g_free (css_fg);
-  g_free (css_warning);
-  g_free (css_error);
-  g_free (css_success);
-  g_free (width);
-  g_free (height);
-
-  stream = g_memory_input_stream_new_from_data (data, -1, g_free);
-  pixbuf = gdk_pixbuf_new_from_stream_at_scale (stream,
-                                                gdk_pixbuf_get_width (icon_info->pixbuf),
-                                                gdk_pixbuf_get_height (icon_info->pixbuf),
-                                                TRUE,
-                                                NULL,
-                                                error);
-  g_object_unref (stream);
+  return file_data;
+}
 
-  return pixbuf;
+static GdkPixbuf *
+gtk_icon_info_load_symbolic_svg (GtkIconInfo    *icon_info,
+                                 const GdkRGBA  *fg,
+                                 const GdkRGBA  *success_color,
+                                 const GdkRGBA  *warning_color,
+                                 const GdkRGBA  *error_color,
+                                 GError        **error)
+{
+  GdkRGBA success_default = { 78 / 255., 154 / 255., 6 / 255., 1.0 };
+  GdkRGBA warning_default = { 245 / 255., 121 / 255., 62 / 255., 1.0 };
+  GdkRGBA error_default = { 204 / 255., 0, 0, 1.0 };
+  GdkPixbuf *pixbuf;
+  gchar *cache_file;
+  gchar *variant;
+  gchar *file_data;
+  gsize file_len;
+
+  if (!success_color)
+    success_color = &success_default;
+  if (!warning_color)
+    warning_color = &warning_default;
+  if (!error_color)
+    error_color = &error_default;
+
+  if (!icon_info_ensure_scale_and_pixbuf (icon_info))
+    {
+      g_propagate_error (error, icon_info->load_error);
+      icon_info->load_error = NULL;
+      return NULL;
+    }
+
+  /* The encoded icon takes three renderings to make. The first set
+   * of colors gets a single rendering of its own instead, unless an
+   * earlier run left the encoded icon in the rendered icon cache.
+   */
+  cache_file = NULL;
+  if (icon_info->symbolic_pixbuf == NULL)
+    {
+      variant = g_strdup_printf ("symbolic\n%d\n%d",
+                                 gdk_pixbuf_get_width (icon_info->pixbuf),
+                                 gdk_pixbuf_get_height (icon_info->pixbuf));
+      cache_file = rendered_icon_cache_file (icon_info, 0, variant);
+      g_free (variant);
+
+      if (cache_file)
+        icon_info->symbolic_pixbuf = rendered_icon_load (cache_file);
+    }
+
+  if (icon_info->symbolic_pixbuf == NULL)
+    {
+      file_data = icon_info_load_symbolic_file (icon_info, &file_len, error);
+      if (file_data == NULL)
+        {
+          g_free (cache_file);
+          return NULL;
+        }
+
+      if (!icon_info->symbolic_rendered)
+        {
+          pixbuf = _gdk_pixbuf_new_symbolic_from_data (file_data, file_len,
+                                                       icon_info->symbolic_width,
+                                                       icon_info->symbolic_height,
+                                                       gdk_pixbuf_get_width (icon_info->pixbuf),
+                                                       gdk_pixbuf_get_height (icon_info->pixbuf),
+                                                       fg,
+                                                       success_color,
+                                                       warning_color,
+                                                       error_color,
+                                                       error);
+          if (pixbuf)
+            icon_info->symbolic_rendered = TRUE;
+
+          g_free (file_data);
+          g_free (cache_file);
+
+          return pixbuf;
+        }
+
+      icon_info->symbolic_pixbuf =
+        _gdk_pixbuf_new_symbolic_encoded_from_data (file_data, file_len,
+                                                    icon_info->symbolic_width,
+                                                    icon_info->symbolic_height,
+                                                    gdk_pixbuf_get_width (icon_info->pixbuf),
+                                                    gdk_pixbuf_get_height (icon_info->pixbuf),
+                                                    error);
+      g_free (file_data);
+
+      if (icon_info->symbolic_pixbuf == NULL)
+        {
+          g_free (cache_file);
+          return NULL;
+        }
+
+      if (cache_file)
+        rendered_icon_store (cache_file, icon_info->symbolic_pixbuf);
+    }
+
+  g_free (cache_file);
+
+  return gtk_icon_theme_color_symbolic_pixbuf (icon_info->symbolic_pixbuf,
+                                               fg,
+                                               success_color,
+                                               warning_color,
+                                               error_color);
 }
 
 
@@ -5040,6 +5454,19 @@ gtk_icon_info_load_symbolic_finish (GtkIconInfo   *icon_info,
 
       g_assert (pixbuf != NULL); /* we checked for !had_error above */
 
+      /* Keep what the thread loaded, so that further loads don't go
+       * back to the rendered icon cache or render again.
+       */
+      if (icon_info->symbolic_pixbuf == NULL && data->dup->symbolic_pixbuf != NULL)
+        icon_info->symbolic_pixbuf = g_object_ref (data->dup->symbolic_pixbuf);
+      icon_info->symbolic_rendered |= data->dup->symbolic_rendered;
+      if (icon_info->pixbuf == NULL && data->dup->pixbuf != NULL)
+        {
+          icon_info->emblems_applied = data->dup->emblems_applied;
+          icon_info->scale = data->dup->scale;
+          icon_info->pixbuf = g_object_ref (data->dup->pixbuf);
+        }
+
       symbolic_cache = symbolic_pixbuf_cache_matches (icon_info->symbolic_pixbuf_cache,
                                                       data->fg_set ? &data->fg : NULL,
                                                       data->success_color_set ? &data->success_color : NULL,
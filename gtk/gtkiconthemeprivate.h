@@ -31,6 +31,12 @@ GtkIconInfo *gtk_icon_info_new_for_file (GFile *file,
                                          gint   size,
                                          gint   scale);
 
+gboolean     gtk_icon_info_is_loaded    (GtkIconInfo   *icon_info,
+                                         const GdkRGBA *fg,
+                                         const GdkRGBA *success_color,
+                                         const GdkRGBA *warning_color,
+                                         const GdkRGBA *error_color);
+
 GdkPixbuf * gtk_icon_theme_color_symbolic_pixbuf (GdkPixbuf     *symbolic,
                                                   const GdkRGBA *fg_color,
                                                   const GdkRGBA *success_color,
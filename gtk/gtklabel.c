@@ -249,6 +249,16 @@
  * the #GtkLabel::activate-link signal and the gtk_label_get_current_uri() function.
  */
 
+/* Number of heights for a given width remembered by a label */
+#define N_CACHED_SIZES 3
+
+typedef struct
+{
+  gint for_size;
+  gint size;
+  gint baseline;
+} GtkLabelCachedSize;
+
 struct _GtkLabelPrivate
 {
   GtkLabelSelectionInfo *select_info;
@@ -285,6 +295,13 @@ struct _GtkLabelPrivate
   gint     width_chars;
   gint     max_width_chars;
   gint     lines;
+
+  /* Measurement results, valid until gtk_label_clear_size_cache() */
+  PangoRectangle     cached_smallest;
+  PangoRectangle     cached_widest;
+  GtkLabelCachedSize cached_sizes[N_CACHED_SIZES];
+  guint              n_cached_sizes;
+  guint              layout_size_valid : 1;
 };
 
 /* Notes about the handling of links:
@@ -468,6 +485,7 @@ static void gtk_label_ensure_select_info  (GtkLabel *label);
 static void gtk_label_clear_select_info   (GtkLabel *label);
 static void gtk_label_update_cursor       (GtkLabel *label);
 static void gtk_label_clear_layout        (GtkLabel *label);
+static void gtk_label_clear_size_cache    (GtkLabel *label);
 static void gtk_label_ensure_layout       (GtkLabel *label);
 static void gtk_label_select_region_index (GtkLabel *label,
                                            gint      anchor_index,
@@ -3102,6 +3120,7 @@ gtk_label_set_width_chars (GtkLabel *label,
     {
       priv->width_chars = n_chars;
       g_object_notify_by_pspec (G_OBJECT (label), label_props[PROP_WIDTH_CHARS]);
+      gtk_label_clear_size_cache (label);
       gtk_widget_queue_resize (GTK_WIDGET (label));
     }
 }
@@ -3149,6 +3168,7 @@ gtk_label_set_max_width_chars (GtkLabel *label,
       priv->max_width_chars = n_chars;
 
       g_object_notify_by_pspec (G_OBJECT (label), label_props[PROP_MAX_WIDTH_CHARS]);
+      gtk_label_clear_size_cache (label);
       gtk_widget_queue_resize (GTK_WIDGET (label));
     }
 }
@@ -3252,6 +3272,7 @@ gtk_label_set_line_wrap_mode (GtkLabel *label,
       priv->wrap_mode = wrap_mode;
       g_object_notify_by_pspec (G_OBJECT (label), label_props[PROP_WRAP_MODE]);
 
+      gtk_label_clear_layout (label);
       gtk_widget_queue_resize (GTK_WIDGET (label));
     }
 }
@@ -3311,10 +3332,64 @@ gtk_label_finalize (GObject *object)
   G_OBJECT_CLASS (gtk_label_parent_class)->finalize (object);
 }
 
+static void
+gtk_label_clear_size_cache (GtkLabel *label)
+{
+  GtkLabelPrivate *priv = label->priv;
+
+  priv->layout_size_valid = FALSE;
+  priv->n_cached_sizes = 0;
+}
+
 static void
 gtk_label_clear_layout (GtkLabel *label)
 {
   g_clear_object (&label->priv->layout);
+  gtk_label_clear_size_cache (label);
+}
+
+static gboolean
+gtk_label_lookup_cached_size (GtkLabel *label,
+                              gint      for_size,
+                              gint     *size,
+                              gint     *baseline)
+{
+  GtkLabelPrivate *priv = label->priv;
+  guint i;
+
+  for (i = 0; i < priv->n_cached_sizes; i++)
+    {
+      if (priv->cached_sizes[i].for_size == for_size)
+        {
+          if (size)
+            *size = priv->cached_sizes[i].size;
+          if (baseline)
+            *baseline = priv->cached_sizes[i].baseline;
+          return TRUE;
+        }
+    }
+
+  return FALSE;
+}
+
+static void
+gtk_label_store_cached_size (GtkLabel *label,
+                             gint      for_size,
+                             gint      size,
+                             gint      baseline)
+{
+  GtkLabelPrivate *priv = label->priv;
+
+  /* Keep the most recent sizes, newest first */
+  if (priv->n_cached_sizes < N_CACHED_SIZES)
+    priv->n_cached_sizes++;
+
+  memmove (&priv->cached_sizes[1], &priv->cached_sizes[0],
+           (priv->n_cached_sizes - 1) * sizeof (GtkLabelCachedSize));
+
+  priv->cached_sizes[0].for_size = for_size;
+  priv->cached_sizes[0].size = size;
+  priv->cached_sizes[0].baseline = baseline;
 }
 
 /**
@@ -3642,21 +3717,26 @@ get_size_for_allocation (GtkLabel *label,
   PangoLayout *layout;
   gint text_height, baseline;
 
-  layout = gtk_label_get_measuring_layout (label, NULL, allocation * PANGO_SCALE);
+  if (!gtk_label_lookup_cached_size (label, allocation, &text_height, &baseline))
+    {
+      layout = gtk_label_get_measuring_layout (label, NULL, allocation * PANGO_SCALE);
+
+      pango_layout_get_pixel_size (layout, NULL, &text_height);
+      baseline = pango_layout_get_baseline (layout) / PANGO_SCALE;
+
+      g_object_unref (layout);
 
-  pango_layout_get_pixel_size (layout, NULL, &text_height);
+      gtk_label_store_cached_size (label, allocation, text_height, baseline);
+    }
 
   *minimum_size = text_height;
   *natural_size = text_height;
 
   if (minimum_baseline || natural_baseline)
     {
-      baseline = pango_layout_get_baseline (layout) / PANGO_SCALE;
       *minimum_baseline = baseline;
       *natural_baseline = baseline;
     }
-
-  g_object_unref (layout);
 }
 
 static gint
@@ -3687,6 +3767,16 @@ gtk_label_get_preferred_layout_size (GtkLabel *label,
   PangoLayout *layout;
   gint char_pixels;
 
+  if (priv->layout_size_valid)
+    {
+      /* Callers expect the layout to exist afterwards */
+      gtk_label_ensure_layout (label);
+
+      *smallest = priv->cached_smallest;
+      *widest = priv->cached_widest;
+      return;
+    }
+
   /* "width-chars" Hard-coded minimum width:
    *    - minimum size should be MAX (width-chars, strlen ("..."));
    *    - natural size should be MAX (width-chars, strlen (priv->text));
@@ -3746,6 +3836,10 @@ gtk_label_get_preferred_layout_size (GtkLabel *label,
     *smallest = *widest;
 
   g_object_unref (layout);
+
+  priv->cached_smallest = *smallest;
+  priv->cached_widest = *widest;
+  priv->layout_size_valid = TRUE;
 }
 
 static void
@@ -3903,14 +3997,17 @@ G_GNUC_END_IGNORE_DEPRECATIONS
     {
       gint size;
 
-      if (priv->wrap)
-        gtk_label_clear_layout (label);
-
       if (orientation == GTK_ORIENTATION_HORIZONTAL)
         size = MAX (1, for_size) - 2 * ypad;
       else
         size = MAX (1, for_size) - 2 * xpad;
 
+      /* Measure with a fresh layout, unless we measured this size
+       * before and can skip the layout entirely.
+       */
+      if (!gtk_label_lookup_cached_size (label, size, NULL, NULL))
+        g_clear_object (&priv->layout);
+
       get_size_for_allocation (label, size, minimum, natural, minimum_baseline, natural_baseline);
 
       if (orientation == GTK_ORIENTATION_HORIZONTAL)
@@ -4237,7 +4334,10 @@ gtk_label_style_updated (GtkWidget *widget)
 
   if (change == NULL || gtk_css_style_change_affects (change, GTK_CSS_AFFECTS_TEXT_ATTRS) ||
       (priv->select_info && priv->select_info->links))
-    gtk_label_update_layout_attributes (label);
+    {
+      gtk_label_clear_size_cache (label);
+      gtk_label_update_layout_attributes (label);
+    }
 }
 
 static PangoDirection
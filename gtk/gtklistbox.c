@@ -2190,8 +2190,71 @@ gtk_list_box_render (GtkCssGadget *gadget,
                      gpointer      data)
 {
   GtkWidget *widget = gtk_css_gadget_get_owner (gadget);
+  GtkListBoxPrivate *priv = BOX_PRIV (widget);
+  GdkRectangle area;
+  GSequenceIter *iter;
+  GSequenceIter *first;
+
+  if (priv->placeholder != NULL)
+    gtk_container_propagate_draw (GTK_CONTAINER (widget), priv->placeholder, cr);
+
+  if (!gdk_cairo_get_clip_rectangle (cr, &area))
+    return FALSE;
+
+  /* Rows are allocated top to bottom, so only the ones overlapping
+   * the clip need to be looked at. Look up the row at the top of the
+   * clip, back up over rows whose clip still reaches into the area,
+   * and stop once a row starts below it.
+   */
+  first = g_sequence_search (priv->children,
+                             GINT_TO_POINTER (area.y),
+                             row_y_cmp_func,
+                             NULL);
+  while (!g_sequence_iter_is_begin (first))
+    {
+      GtkListBoxRow *row;
+      GtkAllocation row_clip;
+
+      iter = g_sequence_iter_prev (first);
+      row = g_sequence_get (iter);
+      if (row_is_visible (row))
+        {
+          gtk_widget_get_clip (GTK_WIDGET (row), &row_clip);
+          if (row_clip.y + row_clip.height <= area.y)
+            break;
+        }
+      first = iter;
+    }
+
+  for (iter = first;
+       !g_sequence_iter_is_end (iter);
+       iter = g_sequence_iter_next (iter))
+    {
+      GtkListBoxRow *row = g_sequence_get (iter);
+      GtkWidget *header = ROW_PRIV (row)->header;
+      GtkAllocation row_clip;
+      int top;
+
+      if (!row_is_visible (row))
+        continue;
 
-  GTK_WIDGET_CLASS (gtk_list_box_parent_class)->draw (widget, cr);
+      gtk_widget_get_clip (GTK_WIDGET (row), &row_clip);
+      top = row_clip.y;
+      if (header != NULL)
+        {
+          GtkAllocation header_clip;
+
+          gtk_widget_get_clip (header, &header_clip);
+          top = MIN (top, header_clip.y);
+        }
+
+      if (top >= area.y + area.height)
+        break;
+
+      if (header != NULL)
+        gtk_container_propagate_draw (GTK_CONTAINER (widget), header, cr);
+      gtk_container_propagate_draw (GTK_CONTAINER (widget), GTK_WIDGET (row), cr);
+    }
 
   return FALSE;
 }
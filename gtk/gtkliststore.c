@@ -191,6 +191,7 @@ struct _GtkListStorePrivate
   GtkSortType order;
 
   guint columns_dirty : 1;
+  guint structure_changes;
 
   gpointer default_sort_data;
   gpointer seq;         /* head of the list */
@@ -243,6 +244,15 @@ static void gtk_list_store_set_column_type (GtkListStore *list_store,
 					    GType         type);
 
 static void gtk_list_store_increment_stamp (GtkListStore *list_store);
+static void gtk_list_store_row_inserted   (GtkTreeModel *tree_model,
+                                           GtkTreePath  *path,
+                                           GtkTreeIter  *iter);
+static void gtk_list_store_row_deleted    (GtkTreeModel *tree_model,
+                                           GtkTreePath  *path);
+static void gtk_list_store_rows_reordered (GtkTreeModel *tree_model,
+                                           GtkTreePath  *path,
+                                           GtkTreeIter  *iter,
+                                           gint         *new_order);
 
 
 /* Drag and Drop */
@@ -337,6 +347,9 @@ gtk_list_store_tree_model_init (GtkTreeModelIface *iface)
   iface->iter_n_children = gtk_list_store_iter_n_children;
   iface->iter_nth_child = gtk_list_store_iter_nth_child;
   iface->iter_parent = gtk_list_store_iter_parent;
+  iface->row_inserted = gtk_list_store_row_inserted;
+  iface->row_deleted = gtk_list_store_row_deleted;
+  iface->rows_reordered = gtk_list_store_rows_reordered;
 }
 
 static void
@@ -565,7 +578,7 @@ gtk_list_store_finalize (GObject *object)
   GtkListStorePrivate *priv = list_store->priv;
 
   g_sequence_foreach (priv->seq,
-		      (GFunc) _gtk_tree_data_list_free, priv->column_headers);
+		      (GFunc) _gtk_tree_data_list_row_free, priv->column_headers);
 
   g_sequence_free (priv->seq);
 
@@ -671,21 +684,17 @@ gtk_list_store_get_value (GtkTreeModel *tree_model,
 {
   GtkListStore *list_store = GTK_LIST_STORE (tree_model);
   GtkListStorePrivate *priv = list_store->priv;
-  GtkTreeDataList *list;
-  gint tmp_column = column;
+  GtkTreeDataList *row;
 
   g_return_if_fail (column < priv->n_columns);
   g_return_if_fail (iter_is_valid (iter, list_store));
 		    
-  list = g_sequence_get (iter->user_data);
+  row = g_sequence_get (iter->user_data);
 
-  while (tmp_column-- > 0 && list)
-    list = list->next;
-
-  if (list == NULL)
+  if (row == NULL)
     g_value_init (value, priv->column_headers[column]);
   else
-    _gtk_tree_data_list_node_to_value (list,
+    _gtk_tree_data_list_node_to_value (&row[column],
 				       priv->column_headers[column],
 				       value);
 }
@@ -821,9 +830,7 @@ gtk_list_store_real_set_value (GtkListStore *list_store,
 			       gboolean      sort)
 {
   GtkListStorePrivate *priv = list_store->priv;
-  GtkTreeDataList *list;
-  GtkTreeDataList *prev;
-  gint old_column = column;
+  GtkTreeDataList *row;
   GValue real_value = G_VALUE_INIT;
   gboolean converted = FALSE;
   gboolean retval = FALSE;
@@ -852,60 +859,25 @@ gtk_list_store_real_set_value (GtkListStore *list_store,
       converted = TRUE;
     }
 
-  prev = list = g_sequence_get (iter->user_data);
+  row = g_sequence_get (iter->user_data);
 
-  while (list != NULL)
+  if (row == NULL)
     {
-      if (column == 0)
-	{
-	  if (converted)
-	    _gtk_tree_data_list_value_to_node (list, &real_value);
-	  else
-	    _gtk_tree_data_list_value_to_node (list, value);
-	  retval = TRUE;
-	  if (converted)
-	    g_value_unset (&real_value);
-         if (sort && GTK_LIST_STORE_IS_SORTED (list_store))
-            gtk_list_store_sort_iter_changed (list_store, iter, old_column);
-	  return retval;
-	}
-
-      column--;
-      prev = list;
-      list = list->next;
-    }
-
-  if (g_sequence_get (iter->user_data) == NULL)
-    {
-      list = _gtk_tree_data_list_alloc();
-      g_sequence_set (iter->user_data, list);
-      list->next = NULL;
-    }
-  else
-    {
-      list = prev->next = _gtk_tree_data_list_alloc ();
-      list->next = NULL;
-    }
-
-  while (column != 0)
-    {
-      list->next = _gtk_tree_data_list_alloc ();
-      list = list->next;
-      list->next = NULL;
-      column --;
+      row = _gtk_tree_data_list_row_new (priv->n_columns);
+      g_sequence_set (iter->user_data, row);
     }
 
   if (converted)
-    _gtk_tree_data_list_value_to_node (list, &real_value);
+    _gtk_tree_data_list_value_to_node (&row[column], &real_value);
   else
-    _gtk_tree_data_list_value_to_node (list, value);
+    _gtk_tree_data_list_value_to_node (&row[column], value);
 
   retval = TRUE;
   if (converted)
     g_value_unset (&real_value);
 
   if (sort && GTK_LIST_STORE_IS_SORTED (list_store))
-    gtk_list_store_sort_iter_changed (list_store, iter, old_column);
+    gtk_list_store_sort_iter_changed (list_store, iter, column);
 
   return retval;
 }
@@ -1211,7 +1183,7 @@ gtk_list_store_remove (GtkListStore *list_store,
   ptr = iter->user_data;
   next = g_sequence_iter_next (ptr);
   
-  _gtk_tree_data_list_free (g_sequence_get (ptr), priv->column_headers);
+  _gtk_tree_data_list_row_free (g_sequence_get (ptr), priv->column_headers);
   g_sequence_remove (iter->user_data);
 
   priv->length--;
@@ -1409,6 +1381,34 @@ gtk_list_store_increment_stamp (GtkListStore *list_store)
   while (priv->stamp == 0);
 }
 
+/* Default handlers of the signals announcing changes to the rows,
+ * counting them so that batch operations notice when a signal handler
+ * changed the store under them.
+ */
+static void
+gtk_list_store_row_inserted (GtkTreeModel *tree_model,
+                             GtkTreePath  *path,
+                             GtkTreeIter  *iter)
+{
+  GTK_LIST_STORE (tree_model)->priv->structure_changes++;
+}
+
+static void
+gtk_list_store_row_deleted (GtkTreeModel *tree_model,
+                            GtkTreePath  *path)
+{
+  GTK_LIST_STORE (tree_model)->priv->structure_changes++;
+}
+
+static void
+gtk_list_store_rows_reordered (GtkTreeModel *tree_model,
+                               GtkTreePath  *path,
+                               GtkTreeIter  *iter,
+                               gint         *new_order)
+{
+  GTK_LIST_STORE (tree_model)->priv->structure_changes++;
+}
+
 /**
  * gtk_list_store_clear:
  * @list_store: a #GtkListStore.
@@ -1590,33 +1590,15 @@ gtk_list_store_drag_data_received (GtkTreeDragDest   *drag_dest,
        */
       if (retval)
         {
-          GtkTreeDataList *dl = g_sequence_get (src_iter.user_data);
-          GtkTreeDataList *copy_head = NULL;
-          GtkTreeDataList *copy_prev = NULL;
-          GtkTreeDataList *copy_iter = NULL;
+          GtkTreeDataList *copy;
 	  GtkTreePath *path;
-          gint col;
-
-          col = 0;
-          while (dl)
-            {
-              copy_iter = _gtk_tree_data_list_node_copy (dl,
-                                                         priv->column_headers[col]);
 
-              if (copy_head == NULL)
-                copy_head = copy_iter;
-
-              if (copy_prev)
-                copy_prev->next = copy_iter;
-
-              copy_prev = copy_iter;
-
-              dl = dl->next;
-              ++col;
-            }
+          copy = _gtk_tree_data_list_row_copy (g_sequence_get (src_iter.user_data),
+                                               priv->n_columns,
+                                               priv->column_headers);
 
 	  dest_iter.stamp = priv->stamp;
-          g_sequence_set (dest_iter.user_data, copy_head);
+          g_sequence_set (dest_iter.user_data, copy);
 
 	  path = gtk_list_store_get_path (tree_model, &dest_iter);
 	  gtk_tree_model_row_changed (tree_model, path, &dest_iter);
@@ -1980,6 +1962,50 @@ gtk_list_store_compare_func (GSequenceIter *a,
   return retval;
 }
 
+static gboolean
+gtk_list_store_sort_by_key (GtkListStore *list_store)
+{
+  GtkListStorePrivate *priv = list_store->priv;
+  GtkTreeDataSortHeader *header;
+  GtkTreeDataSortKey *keys;
+  GSequenceIter *ptr, *end;
+  GtkTreeIter iter;
+  gint n_keys, i;
+
+  if (priv->sort_column_id == -1)
+    return FALSE;
+
+  header = _gtk_tree_data_list_get_header (priv->sort_list,
+                                           priv->sort_column_id);
+  if (header == NULL ||
+      !_gtk_tree_data_list_can_sort_by_key (GTK_TREE_MODEL (list_store),
+                                            header->func, header->data))
+    return FALSE;
+
+  n_keys = g_sequence_get_length (priv->seq);
+  keys = g_new (GtkTreeDataSortKey, n_keys);
+
+  iter.stamp = priv->stamp;
+  ptr = g_sequence_get_begin_iter (priv->seq);
+  for (i = 0; i < n_keys; i++)
+    {
+      iter.user_data = ptr;
+      _gtk_tree_data_list_sort_key_init (&keys[i], GTK_TREE_MODEL (list_store),
+                                         &iter, header->data, ptr, i);
+      ptr = g_sequence_iter_next (ptr);
+    }
+
+  _gtk_tree_data_list_sort_keys (keys, n_keys, priv->order);
+
+  end = g_sequence_get_end_iter (priv->seq);
+  for (i = 0; i < n_keys; i++)
+    g_sequence_move (keys[i].item, end);
+
+  _gtk_tree_data_list_sort_keys_free (keys, n_keys);
+
+  return TRUE;
+}
+
 static void
 gtk_list_store_sort (GtkListStore *list_store)
 {
@@ -1994,7 +2020,8 @@ gtk_list_store_sort (GtkListStore *list_store)
 
   old_positions = save_positions (priv->seq);
 
-  g_sequence_sort_iter (priv->seq, gtk_list_store_compare_func, list_store);
+  if (!gtk_list_store_sort_by_key (list_store))
+    g_sequence_sort_iter (priv->seq, gtk_list_store_compare_func, list_store);
 
   /* Let the world know about our new order */
   new_order = generate_order (priv->seq, old_positions);
@@ -2349,6 +2376,111 @@ gtk_list_store_insert_with_valuesv (GtkListStore *list_store,
   gtk_tree_path_free (path);
 }
 
+/**
+ * gtk_list_store_insert_rows_with_valuesv:
+ * @list_store: A #GtkListStore
+ * @position: position to insert the first new row, or -1 to append
+ * @n_rows: the number of rows to insert
+ * @columns: (array length=n_values): an array of column numbers
+ * @values: (array): an array of @n_rows times @n_values GValues,
+ *     holding the values of the first row followed by those of the
+ *     second row and so on
+ * @n_values: the length of the @columns array
+ *
+ * Inserts @n_rows new rows at @position and sets the values of
+ * @columns in each of them. This has the same effect as calling
+ * gtk_list_store_insert_with_valuesv() for every row with increasing
+ * positions, but avoids looking up the position and path of each
+ * row, which makes it considerably faster for filling a store with
+ * many rows.
+ *
+ * The #GtkTreeModel::row-inserted signal is still emitted for every
+ * row, right after it has been inserted. If a handler changes the rows
+ * of @list_store, the remaining rows are inserted one by one, the
+ * row with index i at @position + i, exactly as the equivalent
+ * individual calls would insert them.
+ *
+ * If the list store is sorted, every row is inserted at its sorted
+ * position instead, as with gtk_list_store_insert_with_valuesv().
+ *
+ * Since: 3.24
+ */
+void
+gtk_list_store_insert_rows_with_valuesv (GtkListStore *list_store,
+                                         gint          position,
+                                         gint          n_rows,
+                                         gint         *columns,
+                                         GValue       *values,
+                                         gint          n_values)
+{
+  GtkListStorePrivate *priv;
+  GtkTreePath *path;
+  GSequenceIter *ptr;
+  GtkTreeIter iter;
+  guint changes;
+  gint length;
+  gint i;
+
+  g_return_if_fail (GTK_IS_LIST_STORE (list_store));
+  g_return_if_fail (n_rows >= 0);
+  g_return_if_fail (n_values == 0 || (columns != NULL && values != NULL));
+
+  priv = list_store->priv;
+
+  if (GTK_LIST_STORE_IS_SORTED (list_store))
+    {
+      for (i = 0; i < n_rows; i++)
+        gtk_list_store_insert_with_valuesv (list_store, NULL, position,
+                                            columns, values + i * n_values, n_values);
+      return;
+    }
+
+  priv->columns_dirty = TRUE;
+
+  length = g_sequence_get_length (priv->seq);
+  if (position > length || position < 0)
+    position = length;
+
+  /* All rows go in front of the same row, so neither that row nor the
+   * path of the next new row ever have to be looked up again.
+   */
+  ptr = g_sequence_get_iter_at_pos (priv->seq, position);
+  path = gtk_tree_path_new_from_indices (position, -1);
+
+  for (i = 0; i < n_rows; i++)
+    {
+      gboolean changed = FALSE;
+      gboolean maybe_need_sort = FALSE;
+
+      iter.stamp = priv->stamp;
+      iter.user_data = g_sequence_insert_before (ptr, NULL);
+
+      priv->length++;
+
+      gtk_list_store_set_vector_internal (list_store, &iter,
+                                          &changed, &maybe_need_sort,
+                                          columns, values + i * n_values, n_values);
+
+      changes = priv->structure_changes + 1;
+      gtk_tree_model_row_inserted (GTK_TREE_MODEL (list_store), path, &iter);
+
+      /* A handler changed the store, so ptr may be gone and the path
+       * may be wrong; insert the rest like individual rows would be.
+       */
+      if (priv->structure_changes != changes)
+        {
+          for (i++; i < n_rows; i++)
+            gtk_list_store_insert_with_valuesv (list_store, NULL, position + i,
+                                                columns, values + i * n_values, n_values);
+          break;
+        }
+
+      gtk_tree_path_next (path);
+    }
+
+  gtk_tree_path_free (path);
+}
+
 /* GtkBuildable custom tag implementation
  *
  * <columns>
@@ -710,49 +710,94 @@ _gtk_rbtree_node_mark_valid (GtkRBTree *tree,
   while (node);
 }
 #endif
+/* The functions below touch every node of a tree and its child trees.
+ * They walk the node structure directly instead of going through
+ * _gtk_rbtree_next(), and recompute the aggregated values of a node
+ * once from its children instead of walking up to the root for every
+ * node they change.
+ */
+static void
+gtk_rbnode_column_invalid (GtkRBNode *node)
+{
+  if (_gtk_rbtree_is_nil (node))
+    return;
+
+  if (! (GTK_RBNODE_FLAG_SET (node, GTK_RBNODE_INVALID)))
+    GTK_RBNODE_SET_FLAG (node, GTK_RBNODE_COLUMN_INVALID);
+  GTK_RBNODE_SET_FLAG (node, GTK_RBNODE_DESCENDANTS_INVALID);
+
+  gtk_rbnode_column_invalid (node->left);
+  gtk_rbnode_column_invalid (node->right);
+  if (node->children)
+    gtk_rbnode_column_invalid (node->children->root);
+}
+
 /* Assume tree is the root node as it doesn't set DESCENDANTS_INVALID above.
  */
 void
 _gtk_rbtree_column_invalid (GtkRBTree *tree)
 {
-  GtkRBNode *node;
-
   if (tree == NULL)
     return;
 
-  node = _gtk_rbtree_first (tree);
+  gtk_rbnode_column_invalid (tree->root);
+}
 
-  do
-    {
-      if (! (GTK_RBNODE_FLAG_SET (node, GTK_RBNODE_INVALID)))
-	GTK_RBNODE_SET_FLAG (node, GTK_RBNODE_COLUMN_INVALID);
-      GTK_RBNODE_SET_FLAG (node, GTK_RBNODE_DESCENDANTS_INVALID);
+static void
+gtk_rbnode_mark_invalid (GtkRBNode *node)
+{
+  if (_gtk_rbtree_is_nil (node))
+    return;
 
-      if (node->children)
-	_gtk_rbtree_column_invalid (node->children);
-    }
-  while ((node = _gtk_rbtree_next (tree, node)) != NULL);
+  GTK_RBNODE_SET_FLAG (node, GTK_RBNODE_INVALID);
+  GTK_RBNODE_SET_FLAG (node, GTK_RBNODE_DESCENDANTS_INVALID);
+
+  gtk_rbnode_mark_invalid (node->left);
+  gtk_rbnode_mark_invalid (node->right);
+  if (node->children)
+    gtk_rbnode_mark_invalid (node->children->root);
 }
 
 void
 _gtk_rbtree_mark_invalid (GtkRBTree *tree)
 {
-  GtkRBNode *node;
-
   if (tree == NULL)
     return;
 
-  node = _gtk_rbtree_first (tree);
+  gtk_rbnode_mark_invalid (tree->root);
+}
 
-  do
-    {
-      GTK_RBNODE_SET_FLAG (node, GTK_RBNODE_INVALID);
-      GTK_RBNODE_SET_FLAG (node, GTK_RBNODE_DESCENDANTS_INVALID);
+static void
+gtk_rbnode_set_fixed_height (GtkRBTree *tree,
+                             GtkRBNode *node,
+                             gint       height,
+                             gboolean   mark_valid)
+{
+  gint node_height;
 
-      if (node->children)
-	_gtk_rbtree_mark_invalid (node->children);
+  if (_gtk_rbtree_is_nil (node))
+    return;
+
+  node_height = GTK_RBNODE_GET_HEIGHT (node);
+  if (GTK_RBNODE_FLAG_SET (node, GTK_RBNODE_INVALID))
+    {
+      node_height = height;
+      if (mark_valid)
+        {
+          GTK_RBNODE_UNSET_FLAG (node, GTK_RBNODE_INVALID);
+          GTK_RBNODE_UNSET_FLAG (node, GTK_RBNODE_COLUMN_INVALID);
+        }
     }
-  while ((node = _gtk_rbtree_next (tree, node)) != NULL);
+
+  gtk_rbnode_set_fixed_height (tree, node->left, height, mark_valid);
+  gtk_rbnode_set_fixed_height (tree, node->right, height, mark_valid);
+  if (node->children)
+    gtk_rbnode_set_fixed_height (node->children, node->children->root,
+                                 height, mark_valid);
+
+  node->offset = node_height + node->left->offset + node->right->offset +
+                 (node->children ? node->children->root->offset : 0);
+  _fixup_validation (tree, node);
 }
 
 void
@@ -760,26 +805,26 @@ _gtk_rbtree_set_fixed_height (GtkRBTree *tree,
 			      gint       height,
 			      gboolean   mark_valid)
 {
-  GtkRBNode *node;
+  gint old_offset;
 
   if (tree == NULL)
     return;
 
-  node = _gtk_rbtree_first (tree);
+  old_offset = tree->root->offset;
 
-  do
-    {
-      if (GTK_RBNODE_FLAG_SET (node, GTK_RBNODE_INVALID))
-        {
-	  _gtk_rbtree_node_set_height (tree, node, height);
-	  if (mark_valid)
-	    _gtk_rbtree_node_mark_valid (tree, node);
-	}
+  gtk_rbnode_set_fixed_height (tree, tree->root, height, mark_valid);
 
-      if (node->children)
-	_gtk_rbtree_set_fixed_height (node->children, height, mark_valid);
-    }
-  while ((node = _gtk_rbtree_next (tree, node)) != NULL);
+  /* Let the parent trees know about our new size */
+  if (tree->parent_tree)
+    gtk_rbnode_adjust (tree->parent_tree,
+                       tree->parent_node,
+                       0, 0,
+                       tree->root->offset - old_offset);
+
+#ifdef G_ENABLE_DEBUG
+  if (GTK_DEBUG_CHECK (TREE))
+    _gtk_rbtree_test (G_STRLOC, tree);
+#endif
 }
 
 static void
@@ -896,6 +896,80 @@ gtk_text_buffer_set_text (GtkTextBuffer *buffer,
     }
 }
 
+/* Upper bound for a single insertion done by
+ * gtk_text_buffer_set_text_from_bytes(); keeps the length in range
+ * of the gint used by the ::insert-text signal.
+ */
+#define BYTES_INSERT_CHUNK_SIZE (64 * 1024 * 1024)
+
+/**
+ * gtk_text_buffer_set_text_from_bytes:
+ * @buffer: a #GtkTextBuffer
+ * @bytes: a #GBytes containing UTF-8 text
+ *
+ * Deletes current contents of @buffer, and inserts the contents of
+ * @bytes instead. The data in @bytes does not need to be
+ * nul-terminated, and must be valid UTF-8.
+ *
+ * Unlike gtk_text_buffer_set_text(), the text is inserted directly
+ * from the memory held by @bytes, so no additional copy of the text
+ * is kept around while the buffer is filled. This makes it suitable
+ * for loading large files through g_mapped_file_get_bytes(), in which
+ * case the file contents are only paged in as they are inserted.
+ * Contents larger than what a single insertion can hold are inserted
+ * in several steps, split at line boundaries.
+ *
+ * Since: 3.24
+ **/
+void
+gtk_text_buffer_set_text_from_bytes (GtkTextBuffer *buffer,
+                                     GBytes        *bytes)
+{
+  GtkTextIter start, end;
+  const gchar *text;
+  gsize len;
+
+  g_return_if_fail (GTK_IS_TEXT_BUFFER (buffer));
+  g_return_if_fail (bytes != NULL);
+
+  text = g_bytes_get_data (bytes, &len);
+
+  gtk_text_buffer_get_bounds (buffer, &start, &end);
+
+  gtk_text_buffer_delete (buffer, &start, &end);
+
+  gtk_text_buffer_get_start_iter (buffer, &end);
+
+  while (len > 0)
+    {
+      gsize chunk_len;
+
+      chunk_len = MIN (len, BYTES_INSERT_CHUNK_SIZE);
+
+      if (chunk_len < len)
+        {
+          gsize i;
+
+          /* Never split a line, and with it a UTF-8 sequence, across
+           * two insertions.
+           */
+          for (i = chunk_len; i > 0 && text[i - 1] != '\n'; i--)
+            ;
+
+          if (i > 0)
+            chunk_len = i;
+          else
+            chunk_len = g_utf8_find_prev_char (text, text + chunk_len) - text;
+        }
+
+      /* Validation happens on insertion */
+      gtk_text_buffer_insert (buffer, &end, text, chunk_len);
+
+      text += chunk_len;
+      len -= chunk_len;
+    }
+}
+
  
 
 /*
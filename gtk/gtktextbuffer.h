@@ -184,6 +184,9 @@ GDK_AVAILABLE_IN_ALL
 void gtk_text_buffer_set_text          (GtkTextBuffer *buffer,
                                         const gchar   *text,
                                         gint           len);
+GDK_AVAILABLE_IN_3_24
+void gtk_text_buffer_set_text_from_bytes (GtkTextBuffer *buffer,
+                                          GBytes        *bytes);
 
 /* Insert into the buffer */
 GDK_AVAILABLE_IN_ALL
@@ -396,12 +396,16 @@ find_list_delta (GSList  *old_list,
   *removed = g_list_reverse (tmp_removed);
 }
 
+/* A section header is a 26 byte name followed by a 32 bit length */
+#define SECTION_NAME_LENGTH   26
+#define SECTION_HEADER_LENGTH (SECTION_NAME_LENGTH + 4)
+
 static void
 serialize_section_header (GString     *str,
 			  const gchar *name,
 			  gint         length)
 {
-  g_return_if_fail (strlen (name) == 26);
+  g_return_if_fail (strlen (name) == SECTION_NAME_LENGTH);
 
   g_string_append (str, name);
 
@@ -412,6 +416,70 @@ serialize_section_header (GString     *str,
   g_string_append_c (str, length & 0xff);
 }
 
+static void
+append_escaped_text (GString     *str,
+                     const gchar *text,
+                     gssize       length)
+{
+  gchar *escaped_text;
+
+  if (length == 0)
+    return;
+
+  escaped_text = g_markup_escape_text (text, length);
+  g_string_append (str, escaped_text);
+  g_free (escaped_text);
+}
+
+/* Appends the text between @start and @end, which must not contain
+ * any tag toggles, replacing pixbufs by references to the pixbuf
+ * sections that are serialized after the text.
+ */
+static void
+serialize_text_run (SerializationContext *context,
+                    const GtkTextIter    *start,
+                    const GtkTextIter    *end)
+{
+  GtkTextIter iter;
+  gchar *text;
+  const gchar *run_start, *p, *q;
+
+  text = gtk_text_iter_get_slice (start, end);
+
+  iter = *start;
+  run_start = text;
+  q = text;
+
+  /* Pixbufs show up as U+FFFC in the slice; only look at the
+   * buffer for these positions instead of walking every character.
+   */
+  for (p = strstr (text, "\357\277\274"); p != NULL; p = strstr (q, "\357\277\274"))
+    {
+      GdkPixbuf *pixbuf;
+
+      gtk_text_iter_forward_chars (&iter, g_utf8_strlen (q, p - q));
+      pixbuf = gtk_text_iter_get_pixbuf (&iter);
+
+      gtk_text_iter_forward_char (&iter);
+      q = p + 3;
+
+      if (pixbuf)
+        {
+          append_escaped_text (context->text_str, run_start, p - run_start);
+          run_start = q;
+
+          g_string_append_printf (context->text_str, "<pixbuf index=\"%d\" />", context->n_pixbufs);
+
+          context->n_pixbufs++;
+          context->pixbufs = g_list_prepend (context->pixbufs, pixbuf);
+        }
+    }
+
+  append_escaped_text (context->text_str, run_start, -1);
+
+  g_free (text);
+}
+
 static void
 serialize_text (GtkTextBuffer        *buffer,
                 SerializationContext *context)
@@ -430,7 +498,6 @@ serialize_text (GtkTextBuffer        *buffer,
     {
       GList *added, *removed;
       GList *tmp;
-      gchar *tmp_text, *escaped_text;
 
       new_tag_list = gtk_text_iter_get_tags (&iter);
       find_list_delta (tag_list, new_tag_list, &added, &removed);
@@ -504,57 +571,12 @@ serialize_text (GtkTextBuffer        *buffer,
 
       old_iter = iter;
 
-      /* Now try to go to either the next tag toggle, or if a pixbuf appears */
-      while (TRUE)
-	{
-	  gunichar ch = gtk_text_iter_get_char (&iter);
-
-	  if (ch == 0xFFFC)
-	    {
-	      GdkPixbuf *pixbuf = gtk_text_iter_get_pixbuf (&iter);
-
-	      if (pixbuf)
-		{
-		  /* Append the text before the pixbuf */
-		  tmp_text = gtk_text_iter_get_slice (&old_iter, &iter);
-		  escaped_text = g_markup_escape_text (tmp_text, -1);
-		  g_free (tmp_text);
+      /* Now go to the next tag toggle */
+      if (!gtk_text_iter_forward_to_tag_toggle (&iter, NULL) ||
+          gtk_text_iter_compare (&iter, &context->end) > 0)
+        iter = context->end;
 
-		  /* Forward so we don't get the 0xfffc char */
-		  gtk_text_iter_forward_char (&iter);
-		  old_iter = iter;
-
-		  g_string_append (context->text_str, escaped_text);
-		  g_free (escaped_text);
-
-		  g_string_append_printf (context->text_str, "<pixbuf index=\"%d\" />", context->n_pixbufs);
-
-		  context->n_pixbufs++;
-		  context->pixbufs = g_list_prepend (context->pixbufs, pixbuf);
-		}
-	    }
-          else if (ch == 0)
-            {
-                break;
-            }
-	  else
-	    gtk_text_iter_forward_char (&iter);
-
-	  if (gtk_text_iter_toggles_tag (&iter, NULL))
-	    break;
-	}
-
-      /* We might have moved too far */
-      if (gtk_text_iter_compare (&iter, &context->end) > 0)
-	iter = context->end;
-
-      /* Append the text */
-      tmp_text = gtk_text_iter_get_slice (&old_iter, &iter);
-      escaped_text = g_markup_escape_text (tmp_text, -1);
-      g_free (tmp_text);
-
-      g_string_append (context->text_str, escaped_text);
-      g_free (escaped_text);
+      serialize_text_run (context, &old_iter, &iter);
     }
   while (!gtk_text_iter_equal (&iter, &context->end));
 
@@ -618,7 +640,8 @@ _gtk_text_buffer_serialize_rich_text (GtkTextBuffer     *register_buffer,
   serialize_text (content_buffer, &context);
   serialize_tags (&context);
 
-  text = g_string_new (NULL);
+  /* Room for the contents section; pixbuf sections are appended after it */
+  text = g_string_sized_new (SECTION_HEADER_LENGTH + context.tag_table_str->len + context.text_str->len);
   serialize_section_header (text, "GTKTEXTBUFFERCONTENTS-0001",
                             context.tag_table_str->len + context.text_str->len);
 
@@ -1669,25 +1692,58 @@ parse_info_free (ParseInfo *info)
 
 }
 
+static void
+apply_tag_from_mark (GtkTextBuffer *buffer,
+                     GtkTextTag    *tag,
+                     GtkTextMark   *mark,
+                     GtkTextIter   *end)
+{
+  GtkTextIter start;
+
+  gtk_text_buffer_get_iter_at_mark (buffer, &start, mark);
+  gtk_text_buffer_apply_tag (buffer, tag, &start, end);
+  gtk_text_buffer_delete_mark (buffer, mark);
+}
+
 static void
 insert_text (ParseInfo   *info,
 	     GtkTextIter *iter)
 {
-  GtkTextIter start_iter;
-  GtkTextMark *mark;
+  GHashTable *open_tags;
+  GHashTableIter hash_iter;
+  gpointer tag, mark;
   GList *tmp;
   GSList *tags;
 
-  start_iter = *iter;
-
-  mark = gtk_text_buffer_create_mark (info->buffer, "deserialize_insert_point",
-  				      &start_iter, TRUE);
+  /* Maps tags to a mark where they start. Tags are applied once over
+   * the whole run of spans that carry them, rather than once for every
+   * span, which adds up for deeply nested <apply_tag> elements.
+   */
+  open_tags = g_hash_table_new (NULL, NULL);
 
   tmp = info->spans;
   while (tmp)
     {
       TextSpan *span = tmp->data;
 
+      /* Apply tags that end before this span */
+      g_hash_table_iter_init (&hash_iter, open_tags);
+      while (g_hash_table_iter_next (&hash_iter, &tag, &mark))
+        {
+          if (g_slist_find (span->tags, tag))
+            continue;
+
+          apply_tag_from_mark (info->buffer, tag, mark, iter);
+          g_hash_table_iter_remove (&hash_iter);
+        }
+
+      for (tags = span->tags; tags; tags = tags->next)
+        {
+          if (!g_hash_table_contains (open_tags, tags->data))
+            g_hash_table_insert (open_tags, tags->data,
+                                 gtk_text_buffer_create_mark (info->buffer, NULL, iter, TRUE));
+        }
+
       if (span->text)
 	gtk_text_buffer_insert (info->buffer, iter, span->text, -1);
       else
@@ -1695,26 +1751,15 @@ insert_text (ParseInfo   *info,
 	  gtk_text_buffer_insert_pixbuf (info->buffer, iter, span->pixbuf);
 	  g_object_unref (span->pixbuf);
 	}
-      gtk_text_buffer_get_iter_at_mark (info->buffer, &start_iter, mark);
-
-      /* Apply tags */
-      tags = span->tags;
-      while (tags)
-	{
-	  GtkTextTag *tag = tags->data;
-
-	  gtk_text_buffer_apply_tag (info->buffer, tag,
-				     &start_iter, iter);
-
-	  tags = tags->next;
-	}
-
-      gtk_text_buffer_move_mark (info->buffer, mark, iter);
 
       tmp = tmp->next;
     }
 
-  gtk_text_buffer_delete_mark (info->buffer, mark);
+  g_hash_table_iter_init (&hash_iter, open_tags);
+  while (g_hash_table_iter_next (&hash_iter, &tag, &mark))
+    apply_tag_from_mark (info->buffer, tag, mark, iter);
+
+  g_hash_table_destroy (open_tags);
 }
 
 
@@ -4910,6 +4910,52 @@ strbreakup (const char *string,
   return str_array;
 }
 
+/* Number of characters fetched at once by block_may_match() */
+#define SEARCH_BLOCK_CHARS 16384
+
+/* Moves @block_end forward to the first line start at least
+ * SEARCH_BLOCK_CHARS after @start and returns whether @first_line can
+ * possibly be found between @start and @block_end. Since the text of
+ * every line in the block is a substring of the text of the whole
+ * block, a negative answer lets the caller skip all these lines without
+ * extracting the text of each one.
+ */
+static gboolean
+block_may_match (const GtkTextIter *start,
+                 GtkTextIter       *block_end,
+                 const gchar       *first_line,
+                 gboolean           visible_only,
+                 gboolean           slice)
+{
+  gchar *block_text;
+  gboolean found;
+
+  gtk_text_iter_forward_chars (block_end, SEARCH_BLOCK_CHARS);
+  if (!gtk_text_iter_starts_line (block_end))
+    gtk_text_iter_forward_line (block_end);
+
+  if (slice)
+    {
+      if (visible_only)
+        block_text = gtk_text_iter_get_visible_slice (start, block_end);
+      else
+        block_text = gtk_text_iter_get_slice (start, block_end);
+    }
+  else
+    {
+      if (visible_only)
+        block_text = gtk_text_iter_get_visible_text (start, block_end);
+      else
+        block_text = gtk_text_iter_get_text (start, block_end);
+    }
+
+  found = strstr (block_text, first_line) != NULL;
+
+  g_free (block_text);
+
+  return found;
+}
+
 /**
  * gtk_text_iter_forward_search:
  * @iter: start of search
@@ -4943,6 +4989,7 @@ gtk_text_iter_forward_search (const GtkTextIter *iter,
   GtkTextIter match;
   gboolean retval = FALSE;
   GtkTextIter search;
+  GtkTextIter block_end;
   gboolean visible_only;
   gboolean slice;
   gboolean case_insensitive;
@@ -4984,8 +5031,9 @@ gtk_text_iter_forward_search (const GtkTextIter *iter,
   lines = strbreakup (str, "\n", -1, NULL, case_insensitive);
 
   search = *iter;
+  block_end = search;
 
-  do
+  while (TRUE)
     {
       /* This loop has an inefficient worst-case, where
        * gtk_text_iter_get_text() is called repeatedly on
@@ -4996,7 +5044,23 @@ gtk_text_iter_forward_search (const GtkTextIter *iter,
       if (limit &&
           gtk_text_iter_compare (&search, limit) >= 0)
         break;
-      
+
+      if (!case_insensitive &&
+          gtk_text_iter_compare (&search, &block_end) >= 0)
+        {
+          block_end = search;
+
+          if (!block_may_match (&search, &block_end, lines[0],
+                                visible_only, slice))
+            {
+              if (gtk_text_iter_is_end (&block_end))
+                break;
+
+              search = block_end;
+              continue;
+            }
+        }
+
       if (lines_match (&search, (const gchar**)lines,
                        visible_only, slice, case_insensitive, &match, &end))
         {
@@ -5015,8 +5079,10 @@ gtk_text_iter_forward_search (const GtkTextIter *iter,
           
           break;
         }
+
+      if (!gtk_text_iter_forward_line (&search))
+        break;
     }
-  while (gtk_text_iter_forward_line (&search));
 
   g_strfreev ((gchar**)lines);
 
@@ -34,6 +34,20 @@ _gtk_tree_data_list_alloc (void)
   return list;
 }
 
+static void
+node_free_data (GtkTreeDataList *node,
+                GType            type)
+{
+  if (g_type_is_a (type, G_TYPE_STRING))
+    g_free ((gchar *) node->data.v_pointer);
+  else if (g_type_is_a (type, G_TYPE_OBJECT) && node->data.v_pointer != NULL)
+    g_object_unref (node->data.v_pointer);
+  else if (g_type_is_a (type, G_TYPE_BOXED) && node->data.v_pointer != NULL)
+    g_boxed_free (type, (gpointer) node->data.v_pointer);
+  else if (g_type_is_a (type, G_TYPE_VARIANT) && node->data.v_pointer != NULL)
+    g_variant_unref ((gpointer) node->data.v_pointer);
+}
+
 void
 _gtk_tree_data_list_free (GtkTreeDataList *list,
 			  GType           *column_headers)
@@ -46,21 +60,50 @@ _gtk_tree_data_list_free (GtkTreeDataList *list,
   while (tmp)
     {
       next = tmp->next;
-      if (g_type_is_a (column_headers [i], G_TYPE_STRING))
-	g_free ((gchar *) tmp->data.v_pointer);
-      else if (g_type_is_a (column_headers [i], G_TYPE_OBJECT) && tmp->data.v_pointer != NULL)
-	g_object_unref (tmp->data.v_pointer);
-      else if (g_type_is_a (column_headers [i], G_TYPE_BOXED) && tmp->data.v_pointer != NULL)
-	g_boxed_free (column_headers [i], (gpointer) tmp->data.v_pointer);
-      else if (g_type_is_a (column_headers [i], G_TYPE_VARIANT) && tmp->data.v_pointer != NULL)
-	g_variant_unref ((gpointer) tmp->data.v_pointer);
-
+      node_free_data (tmp, column_headers[i]);
       g_slice_free (GtkTreeDataList, tmp);
       i++;
       tmp = next;
     }
 }
 
+/* Rows are an alternative to lists built node by node: all nodes of
+ * a row are allocated in one contiguous block, so the node for a column
+ * can be accessed directly by index. The nodes are still linked, so a
+ * row can be walked like any other list.
+ */
+GtkTreeDataList *
+_gtk_tree_data_list_row_new (gint n_columns)
+{
+  GtkTreeDataList *row;
+  gint i;
+
+  g_return_val_if_fail (n_columns > 0, NULL);
+
+  row = g_new0 (GtkTreeDataList, n_columns);
+
+  for (i = 0; i < n_columns - 1; i++)
+    row[i].next = &row[i + 1];
+
+  return row;
+}
+
+void
+_gtk_tree_data_list_row_free (GtkTreeDataList *row,
+                              GType           *column_headers)
+{
+  GtkTreeDataList *tmp;
+  gint i = 0;
+
+  if (row == NULL)
+    return;
+
+  for (tmp = row; tmp; tmp = tmp->next)
+    node_free_data (tmp, column_headers[i++]);
+
+  g_free (row);
+}
+
 gboolean
 _gtk_tree_data_list_check_type (GType type)
 {
@@ -258,17 +301,11 @@ _gtk_tree_data_list_value_to_node (GtkTreeDataList *list,
     }
 }
 
-GtkTreeDataList *
-_gtk_tree_data_list_node_copy (GtkTreeDataList *list,
-                               GType            type)
+static void
+node_copy_data (GtkTreeDataList *list,
+                GtkTreeDataList *new_list,
+                GType            type)
 {
-  GtkTreeDataList *new_list;
-
-  g_return_val_if_fail (list != NULL, NULL);
-  
-  new_list = _gtk_tree_data_list_alloc ();
-  new_list->next = NULL;
-
   switch (get_fundamental_type (type))
     {
     case G_TYPE_BOOLEAN:
@@ -312,10 +349,43 @@ _gtk_tree_data_list_node_copy (GtkTreeDataList *list,
       g_warning ("Unsupported node type (%s) copied.", g_type_name (type));
       break;
     }
+}
+
+GtkTreeDataList *
+_gtk_tree_data_list_node_copy (GtkTreeDataList *list,
+                               GType            type)
+{
+  GtkTreeDataList *new_list;
+
+  g_return_val_if_fail (list != NULL, NULL);
+  
+  new_list = _gtk_tree_data_list_alloc ();
+  new_list->next = NULL;
+
+  node_copy_data (list, new_list, type);
 
   return new_list;
 }
 
+GtkTreeDataList *
+_gtk_tree_data_list_row_copy (GtkTreeDataList *row,
+                              gint             n_columns,
+                              GType           *column_headers)
+{
+  GtkTreeDataList *new_row;
+  gint i;
+
+  if (row == NULL)
+    return NULL;
+
+  new_row = _gtk_tree_data_list_row_new (n_columns);
+
+  for (i = 0; i < n_columns; i++)
+    node_copy_data (&row[i], &new_row[i], column_headers[i]);
+
+  return new_row;
+}
+
 gint
 _gtk_tree_data_list_compare_func (GtkTreeModel *model,
 				  GtkTreeIter  *a,
@@ -463,6 +533,88 @@ _gtk_tree_data_list_compare_func (GtkTreeModel *model,
   return retval;
 }
 
+/* Sorting a large model by a string column through
+ * _gtk_tree_data_list_compare_func() fetches and collates both
+ * strings on every comparison. Models can instead compute one
+ * collation key per row and sort those.
+ */
+gboolean
+_gtk_tree_data_list_can_sort_by_key (GtkTreeModel           *model,
+                                     GtkTreeIterCompareFunc  func,
+                                     gpointer                data)
+{
+  GType type;
+
+  if (func != _gtk_tree_data_list_compare_func)
+    return FALSE;
+
+  type = gtk_tree_model_get_column_type (model, GPOINTER_TO_INT (data));
+
+  return get_fundamental_type (type) == G_TYPE_STRING;
+}
+
+void
+_gtk_tree_data_list_sort_key_init (GtkTreeDataSortKey *key,
+                                   GtkTreeModel       *model,
+                                   GtkTreeIter        *iter,
+                                   gpointer            data,
+                                   gpointer            item,
+                                   gint                position)
+{
+  GValue value = G_VALUE_INIT;
+  const gchar *str;
+
+  gtk_tree_model_get_value (model, iter, GPOINTER_TO_INT (data), &value);
+  str = g_value_get_string (&value);
+  key->key = g_utf8_collate_key (str ? str : "", -1);
+  key->item = item;
+  key->position = position;
+  g_value_unset (&value);
+}
+
+static gint
+sort_key_compare (gconstpointer a,
+                  gconstpointer b,
+                  gpointer      user_data)
+{
+  const GtkTreeDataSortKey *ka = a;
+  const GtkTreeDataSortKey *kb = b;
+  GtkSortType order = GPOINTER_TO_INT (user_data);
+  gint retval;
+
+  retval = strcmp (ka->key, kb->key);
+  if (order == GTK_SORT_DESCENDING)
+    retval = -retval;
+
+  /* Keep rows that compare equal in their old order, like
+   * g_sequence_sort() does.
+   */
+  if (retval == 0)
+    retval = ka->position - kb->position;
+
+  return retval;
+}
+
+void
+_gtk_tree_data_list_sort_keys (GtkTreeDataSortKey *keys,
+                               gint                n_keys,
+                               GtkSortType         order)
+{
+  g_qsort_with_data (keys, n_keys, sizeof (GtkTreeDataSortKey),
+                     sort_key_compare, GINT_TO_POINTER (order));
+}
+
+void
+_gtk_tree_data_list_sort_keys_free (GtkTreeDataSortKey *keys,
+                                    gint                n_keys)
+{
+  gint i;
+
+  for (i = 0; i < n_keys; i++)
+    g_free (keys[i].key);
+  g_free (keys);
+}
+
 
 GList *
 _gtk_tree_data_list_header_new (gint   n_columns,
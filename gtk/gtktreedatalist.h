@@ -49,6 +49,13 @@ typedef struct _GtkTreeDataSortHeader
   GDestroyNotify destroy;
 } GtkTreeDataSortHeader;
 
+typedef struct _GtkTreeDataSortKey
+{
+  gpointer item;
+  gint position;
+  gchar *key;
+} GtkTreeDataSortKey;
+
 GtkTreeDataList *_gtk_tree_data_list_alloc          (void);
 void             _gtk_tree_data_list_free           (GtkTreeDataList *list,
 						     GType           *column_headers);
@@ -62,11 +69,32 @@ void             _gtk_tree_data_list_value_to_node  (GtkTreeDataList *list,
 GtkTreeDataList *_gtk_tree_data_list_node_copy      (GtkTreeDataList *list,
                                                      GType            type);
 
+GtkTreeDataList *_gtk_tree_data_list_row_new        (gint             n_columns);
+void             _gtk_tree_data_list_row_free       (GtkTreeDataList *row,
+                                                     GType           *column_headers);
+GtkTreeDataList *_gtk_tree_data_list_row_copy       (GtkTreeDataList *row,
+                                                     gint             n_columns,
+                                                     GType           *column_headers);
+
 /* Header code */
 gint                   _gtk_tree_data_list_compare_func (GtkTreeModel *model,
 							 GtkTreeIter  *a,
 							 GtkTreeIter  *b,
 							 gpointer      user_data);
+gboolean               _gtk_tree_data_list_can_sort_by_key (GtkTreeModel           *model,
+                                                            GtkTreeIterCompareFunc  func,
+                                                            gpointer                data);
+void                   _gtk_tree_data_list_sort_key_init   (GtkTreeDataSortKey     *key,
+                                                            GtkTreeModel           *model,
+                                                            GtkTreeIter            *iter,
+                                                            gpointer                data,
+                                                            gpointer                item,
+                                                            gint                    position);
+void                   _gtk_tree_data_list_sort_keys       (GtkTreeDataSortKey     *keys,
+                                                            gint                    n_keys,
+                                                            GtkSortType             order);
+void                   _gtk_tree_data_list_sort_keys_free  (GtkTreeDataSortKey     *keys,
+                                                            gint                    n_keys);
 GList *                _gtk_tree_data_list_header_new  (gint          n_columns,
 							GType        *types);
 void                   _gtk_tree_data_list_header_free (GList        *header_list);
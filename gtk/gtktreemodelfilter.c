@@ -288,6 +288,10 @@ struct _GtkTreeModelFilterPrivate
   guint in_row_deleted       : 1;
   guint virtual_root_deleted : 1;
 
+  /* pending gtk_tree_model_filter_queue_refilter() */
+  guint refilter_id;
+  GtkTreeRowReference *refilter_next;
+
   /* signal ids */
   gulong changed_id;
   gulong inserted_id;
@@ -321,6 +325,9 @@ enum
  */
 #undef MODEL_FILTER_DEBUG
 
+/* How long a single step of a queued refilter may run, in microseconds */
+#define REFILTER_SLICE_TIME 5000
+
 #define FILTER_ELT(filter_elt) ((FilterElt *)filter_elt)
 #define FILTER_LEVEL(filter_level) ((FilterLevel *)filter_level)
 #define GET_ELT(siter) ((FilterElt*) (siter ? g_sequence_get (siter) : NULL))
@@ -453,6 +460,7 @@ static void         gtk_tree_model_filter_real_unref_node                 (GtkTr
                                                                            gboolean                external,
                                                                            gboolean                propagate_unref);
 
+static void         gtk_tree_model_filter_cancel_refilter                 (GtkTreeModelFilter     *filter);
 static void         gtk_tree_model_filter_set_model                       (GtkTreeModelFilter     *filter,
                                                                            GtkTreeModel           *child_model);
 static void         gtk_tree_model_filter_ref_path                        (GtkTreeModelFilter     *filter,
@@ -577,6 +585,8 @@ gtk_tree_model_filter_finalize (GObject *object)
 {
   GtkTreeModelFilter *filter = (GtkTreeModelFilter *) object;
 
+  gtk_tree_model_filter_cancel_refilter (filter);
+
   if (filter->priv->virtual_root && !filter->priv->virtual_root_deleted)
     {
       gtk_tree_model_filter_unref_path (filter, filter->priv->virtual_root,
@@ -4260,12 +4270,143 @@ gtk_tree_model_filter_refilter (GtkTreeModelFilter *filter)
 {
   g_return_if_fail (GTK_IS_TREE_MODEL_FILTER (filter));
 
+  gtk_tree_model_filter_cancel_refilter (filter);
+
   /* S L O W */
   gtk_tree_model_foreach (filter->priv->child_model,
                           gtk_tree_model_filter_refilter_helper,
                           filter);
 }
 
+static void
+gtk_tree_model_filter_cancel_refilter (GtkTreeModelFilter *filter)
+{
+  if (filter->priv->refilter_id)
+    {
+      g_source_remove (filter->priv->refilter_id);
+      filter->priv->refilter_id = 0;
+    }
+
+  g_clear_pointer (&filter->priv->refilter_next, gtk_tree_row_reference_free);
+}
+
+/* Moves @iter and @path to the next row of @model in the order
+ * gtk_tree_model_foreach() visits them.
+ */
+static gboolean
+gtk_tree_model_filter_refilter_next (GtkTreeModel *model,
+                                     GtkTreeIter  *iter,
+                                     GtkTreePath  *path)
+{
+  GtkTreeIter tmp;
+
+  if (gtk_tree_model_iter_children (model, &tmp, iter))
+    {
+      gtk_tree_path_down (path);
+      *iter = tmp;
+      return TRUE;
+    }
+
+  while (TRUE)
+    {
+      tmp = *iter;
+      if (gtk_tree_model_iter_next (model, &tmp))
+        {
+          gtk_tree_path_next (path);
+          *iter = tmp;
+          return TRUE;
+        }
+
+      if (!gtk_tree_model_iter_parent (model, &tmp, iter))
+        return FALSE;
+
+      gtk_tree_path_up (path);
+      *iter = tmp;
+    }
+}
+
+static gboolean
+gtk_tree_model_filter_refilter_step (gpointer data)
+{
+  GtkTreeModelFilter *filter = GTK_TREE_MODEL_FILTER (data);
+  GtkTreeModel *child_model = filter->priv->child_model;
+  guint refilter_id = filter->priv->refilter_id;
+  GtkTreePath *path;
+  GtkTreeIter iter;
+  gboolean more;
+  gint64 end_time;
+
+  /* The row reference follows the child model through insertions,
+   * deletions and reorderings between steps. If the row we were going
+   * to continue with went away, we have lost our place and start over.
+   */
+  if (filter->priv->refilter_next &&
+      gtk_tree_row_reference_valid (filter->priv->refilter_next))
+    path = gtk_tree_row_reference_get_path (filter->priv->refilter_next);
+  else
+    path = gtk_tree_path_new_first ();
+
+  g_clear_pointer (&filter->priv->refilter_next, gtk_tree_row_reference_free);
+
+  more = gtk_tree_model_get_iter (child_model, &iter, path);
+  end_time = g_get_monotonic_time () + REFILTER_SLICE_TIME;
+
+  while (more)
+    {
+      gtk_tree_model_filter_row_changed (child_model, path, &iter, filter);
+      more = gtk_tree_model_filter_refilter_next (child_model, &iter, path);
+
+      /* The visible function may have cancelled or restarted us */
+      if (filter->priv->refilter_id != refilter_id)
+        {
+          gtk_tree_path_free (path);
+          return G_SOURCE_REMOVE;
+        }
+
+      if (g_get_monotonic_time () >= end_time)
+        break;
+    }
+
+  if (more)
+    filter->priv->refilter_next = gtk_tree_row_reference_new (child_model, path);
+  else
+    filter->priv->refilter_id = 0;
+
+  gtk_tree_path_free (path);
+
+  return more ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
+}
+
+/**
+ * gtk_tree_model_filter_queue_refilter:
+ * @filter: A #GtkTreeModelFilter.
+ *
+ * Like gtk_tree_model_filter_refilter(), but re-evaluates the
+ * visibility of the rows in the child model in small steps from an
+ * idle handler, so that the main loop keeps running while a large
+ * model is being refiltered.
+ *
+ * Calling this function again while a refilter is pending starts
+ * over from the first row. Calling gtk_tree_model_filter_refilter()
+ * cancels the pending refilter and finishes the work immediately.
+ *
+ * Since: 3.24
+ */
+void
+gtk_tree_model_filter_queue_refilter (GtkTreeModelFilter *filter)
+{
+  g_return_if_fail (GTK_IS_TREE_MODEL_FILTER (filter));
+
+  gtk_tree_model_filter_cancel_refilter (filter);
+
+  filter->priv->refilter_id =
+    g_idle_add_full (G_PRIORITY_DEFAULT_IDLE,
+                     gtk_tree_model_filter_refilter_step,
+                     filter, NULL);
+  g_source_set_name_by_id (filter->priv->refilter_id,
+                           "[gtk+] gtk_tree_model_filter_refilter_step");
+}
+
 /**
  * gtk_tree_model_filter_clear_cache:
  * @filter: A #GtkTreeModelFilter.
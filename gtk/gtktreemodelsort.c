@@ -1884,6 +1884,54 @@ gtk_tree_model_sort_offset_compare_func (gconstpointer a,
   return retval;
 }
 
+static gboolean
+gtk_tree_model_sort_sort_level_by_key (SortLevel *level,
+                                       SortData  *data)
+{
+  GtkTreeModelSort *tree_model_sort = data->tree_model_sort;
+  GtkTreeModelSortPrivate *priv = tree_model_sort->priv;
+  GtkTreeDataSortKey *keys;
+  GSequenceIter *siter, *end_siter;
+  GtkTreeIter iter;
+  gint n_keys, i;
+
+  if (!_gtk_tree_data_list_can_sort_by_key (priv->child_model,
+                                            data->sort_func,
+                                            data->sort_data))
+    return FALSE;
+
+  n_keys = g_sequence_get_length (level->seq);
+  keys = g_new (GtkTreeDataSortKey, n_keys);
+
+  siter = g_sequence_get_begin_iter (level->seq);
+  for (i = 0; i < n_keys; i++)
+    {
+      SortElt *elt = g_sequence_get (siter);
+
+      if (GTK_TREE_MODEL_SORT_CACHE_CHILD_ITERS (tree_model_sort))
+        iter = elt->iter;
+      else
+        {
+          data->parent_path_indices [data->parent_path_depth-1] = elt->offset;
+          gtk_tree_model_get_iter (priv->child_model, &iter, data->parent_path);
+        }
+
+      _gtk_tree_data_list_sort_key_init (&keys[i], priv->child_model, &iter,
+                                         data->sort_data, siter, i);
+      siter = g_sequence_iter_next (siter);
+    }
+
+  _gtk_tree_data_list_sort_keys (keys, n_keys, priv->order);
+
+  end_siter = g_sequence_get_end_iter (level->seq);
+  for (i = 0; i < n_keys; i++)
+    g_sequence_move (keys[i].item, end_siter);
+
+  _gtk_tree_data_list_sort_keys_free (keys, n_keys);
+
+  return TRUE;
+}
+
 static void
 gtk_tree_model_sort_sort_level (GtkTreeModelSort *tree_model_sort,
 				SortLevel        *level,
@@ -1932,7 +1980,7 @@ gtk_tree_model_sort_sort_level (GtkTreeModelSort *tree_model_sort,
   if (data.sort_func == NO_SORT_FUNC)
     g_sequence_sort (level->seq, gtk_tree_model_sort_offset_compare_func,
                      &data);
-  else
+  else if (!gtk_tree_model_sort_sort_level_by_key (level, &data))
     g_sequence_sort (level->seq, gtk_tree_model_sort_compare_func, &data);
 
   free_sort_data (&data);
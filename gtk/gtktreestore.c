@@ -76,6 +76,7 @@ struct _GtkTreeStorePrivate
   gpointer default_sort_data;
   GDestroyNotify default_sort_destroy;
   guint columns_dirty : 1;
+  guint structure_changes;
 };
 
 
@@ -129,6 +130,15 @@ static void gtk_tree_store_set_column_type (GtkTreeStore *tree_store,
 					    GType         type);
 
 static void gtk_tree_store_increment_stamp (GtkTreeStore  *tree_store);
+static void gtk_tree_store_row_inserted   (GtkTreeModel *tree_model,
+                                           GtkTreePath  *path,
+                                           GtkTreeIter  *iter);
+static void gtk_tree_store_row_deleted    (GtkTreeModel *tree_model,
+                                           GtkTreePath  *path);
+static void gtk_tree_store_rows_reordered (GtkTreeModel *tree_model,
+                                           GtkTreePath  *path,
+                                           GtkTreeIter  *iter,
+                                           gint         *new_order);
 
 
 /* DND interfaces */
@@ -246,6 +256,9 @@ gtk_tree_store_tree_model_init (GtkTreeModelIface *iface)
   iface->iter_n_children = gtk_tree_store_iter_n_children;
   iface->iter_nth_child = gtk_tree_store_iter_nth_child;
   iface->iter_parent = gtk_tree_store_iter_parent;
+  iface->row_inserted = gtk_tree_store_row_inserted;
+  iface->row_deleted = gtk_tree_store_row_deleted;
+  iface->rows_reordered = gtk_tree_store_rows_reordered;
 }
 
 static void
@@ -1655,6 +1668,144 @@ gtk_tree_store_insert_with_valuesv (GtkTreeStore *tree_store,
   validate_tree ((GtkTreeStore *)tree_store);
 }
 
+/**
+ * gtk_tree_store_insert_rows_with_valuesv:
+ * @tree_store: A #GtkTreeStore
+ * @parent: (allow-none): A valid #GtkTreeIter, or %NULL
+ * @position: position to insert the first new row, or -1 to append
+ * @n_rows: the number of rows to insert
+ * @columns: (array length=n_values): an array of column numbers
+ * @values: (array): an array of @n_rows times @n_values GValues,
+ *     holding the values of the first row followed by those of the
+ *     second row and so on
+ * @n_values: the length of the @columns array
+ *
+ * Inserts @n_rows new children of @parent at @position and sets the
+ * values of @columns in each of them. This has the same effect as
+ * calling gtk_tree_store_insert_with_valuesv() for every row with
+ * increasing positions, but avoids walking the siblings of each new
+ * row to find its position and path, which makes filling a level with
+ * many rows take linear instead of quadratic time.
+ *
+ * The #GtkTreeModel::row-inserted signal is still emitted for every
+ * row, right after it has been inserted. If a handler changes the rows
+ * of @tree_store, the remaining rows are inserted one by one, the
+ * row with index i at @position + i, exactly as the equivalent
+ * individual calls would insert them.
+ *
+ * If the tree store is sorted, every row is inserted at its sorted
+ * position instead, as with gtk_tree_store_insert_with_valuesv().
+ *
+ * Since: 3.24
+ */
+void
+gtk_tree_store_insert_rows_with_valuesv (GtkTreeStore *tree_store,
+                                         GtkTreeIter  *parent,
+                                         gint          position,
+                                         gint          n_rows,
+                                         gint         *columns,
+                                         GValue       *values,
+                                         gint          n_values)
+{
+  GtkTreeStorePrivate *priv;
+  GtkTreePath *path;
+  GNode *parent_node;
+  GNode *sibling;
+  GtkTreeIter iter;
+  gboolean had_children;
+  guint changes;
+  gint n_children;
+  gint i;
+
+  g_return_if_fail (GTK_IS_TREE_STORE (tree_store));
+  g_return_if_fail (n_rows >= 0);
+  g_return_if_fail (n_values == 0 || (columns != NULL && values != NULL));
+  if (parent)
+    g_return_if_fail (VALID_ITER (parent, tree_store));
+
+  priv = tree_store->priv;
+
+  if (GTK_TREE_STORE_IS_SORTED (tree_store))
+    {
+      for (i = 0; i < n_rows; i++)
+        gtk_tree_store_insert_with_valuesv (tree_store, NULL, parent, position,
+                                            columns, values + i * n_values, n_values);
+      return;
+    }
+
+  if (n_rows == 0)
+    return;
+
+  if (parent)
+    parent_node = parent->user_data;
+  else
+    parent_node = priv->root;
+
+  priv->columns_dirty = TRUE;
+
+  n_children = g_node_n_children (parent_node);
+  if (position < 0 || position > n_children)
+    position = n_children;
+
+  had_children = n_children > 0;
+  sibling = position > 0 ? g_node_nth_child (parent_node, position - 1) : NULL;
+
+  if (parent)
+    {
+      path = gtk_tree_store_get_path (GTK_TREE_MODEL (tree_store), parent);
+      gtk_tree_path_append_index (path, position);
+    }
+  else
+    path = gtk_tree_path_new_from_indices (position, -1);
+
+  for (i = 0; i < n_rows; i++)
+    {
+      gboolean changed = FALSE;
+      gboolean maybe_need_sort = FALSE;
+      GNode *new_node;
+
+      new_node = g_node_new (NULL);
+      g_node_insert_after (parent_node, sibling, new_node);
+      sibling = new_node;
+
+      iter.stamp = priv->stamp;
+      iter.user_data = new_node;
+
+      gtk_tree_store_set_vector_internal (tree_store, &iter,
+                                          &changed, &maybe_need_sort,
+                                          columns, values + i * n_values, n_values);
+
+      changes = priv->structure_changes + 1;
+      gtk_tree_model_row_inserted (GTK_TREE_MODEL (tree_store), path, &iter);
+
+      if (i == 0 && parent_node != priv->root && !had_children)
+        {
+          GtkTreePath *parent_path = gtk_tree_path_copy (path);
+
+          gtk_tree_path_up (parent_path);
+          gtk_tree_model_row_has_child_toggled (GTK_TREE_MODEL (tree_store), parent_path, parent);
+          gtk_tree_path_free (parent_path);
+        }
+
+      /* A handler changed the store, so sibling may be gone and the
+       * path may be wrong; insert the rest like individual rows would be.
+       */
+      if (priv->structure_changes != changes)
+        {
+          for (i++; i < n_rows; i++)
+            gtk_tree_store_insert_with_valuesv (tree_store, NULL, parent, position + i,
+                                                columns, values + i * n_values, n_values);
+          break;
+        }
+
+      gtk_tree_path_next (path);
+    }
+
+  gtk_tree_path_free (path);
+
+  validate_tree (tree_store);
+}
+
 /**
  * gtk_tree_store_prepend:
  * @tree_store: A #GtkTreeStore
@@ -1870,6 +2021,34 @@ gtk_tree_store_increment_stamp (GtkTreeStore *tree_store)
   while (priv->stamp == 0);
 }
 
+/* Default handlers of the signals announcing changes to the rows,
+ * counting them so that batch operations notice when a signal handler
+ * changed the store under them.
+ */
+static void
+gtk_tree_store_row_inserted (GtkTreeModel *tree_model,
+                             GtkTreePath  *path,
+                             GtkTreeIter  *iter)
+{
+  GTK_TREE_STORE (tree_model)->priv->structure_changes++;
+}
+
+static void
+gtk_tree_store_row_deleted (GtkTreeModel *tree_model,
+                            GtkTreePath  *path)
+{
+  GTK_TREE_STORE (tree_model)->priv->structure_changes++;
+}
+
+static void
+gtk_tree_store_rows_reordered (GtkTreeModel *tree_model,
+                               GtkTreePath  *path,
+                               GtkTreeIter  *iter,
+                               gint         *new_order)
+{
+  GTK_TREE_STORE (tree_model)->priv->structure_changes++;
+}
+
 /**
  * gtk_tree_store_clear:
  * @tree_store: a #GtkTreeStore
@@ -244,6 +244,13 @@ typedef enum {
 #define GTK_TREE_VIEW_PRIORITY_SCROLL_SYNC (GTK_TREE_VIEW_PRIORITY_VALIDATE + 2)
 /* 3/5 of gdkframeclockidle.c's FRAME_INTERVAL (16667 microsecs) */
 #define GTK_TREE_VIEW_TIME_MS_PER_IDLE 10
+/* Rows measured right away when autosizing a column in a larger model.
+ * The visible rows and this many rows spread over the model give the
+ * width the column starts with; a wider row outside the sample only
+ * widens the column once idle validation reaches it, so the width can
+ * be too small for a while after autosizing.
+ */
+#define GTK_TREE_VIEW_AUTOSIZE_SAMPLE_ROWS 1000
 #define SCROLL_EDGE_SIZE 15
 #define GTK_TREE_VIEW_SEARCH_DIALOG_TIMEOUT 5000
 #define AUTO_EXPAND_TIMEOUT 500
@@ -5191,23 +5198,32 @@ gtk_tree_view_bin_draw (GtkWidget      *widget,
       if (GTK_RBNODE_FLAG_SET (node, GTK_RBNODE_IS_SELECTED))
         flags |= GTK_CELL_RENDERER_SELECTED;
 
-      /* we *need* to set cell data on all cells before the call
-       * to _has_can_focus_cell, else _has_can_focus_cell() does not
-       * return a correct value.
+      /* Only the cursor row needs to know whether there is a focusable
+       * cell. Every other row only sets the cell data of the columns
+       * it actually draws, below.
        */
-      for (list = (rtl ? g_list_last (tree_view->priv->columns) : g_list_first (tree_view->priv->columns));
-	   list;
-	   list = (rtl ? list->prev : list->next))
+      if (node == tree_view->priv->cursor_node)
         {
-	  GtkTreeViewColumn *column = list->data;
-	  gtk_tree_view_column_cell_set_cell_data (column,
-						   tree_view->priv->model,
-						   &iter,
-						   GTK_RBNODE_FLAG_SET (node, GTK_RBNODE_IS_PARENT),
-						   node->children?TRUE:FALSE);
-        }
+          /* we *need* to set cell data on all cells before the call
+           * to _has_can_focus_cell, else _has_can_focus_cell() does not
+           * return a correct value.
+           */
+          for (list = (rtl ? g_list_last (tree_view->priv->columns) : g_list_first (tree_view->priv->columns));
+               list;
+               list = (rtl ? list->prev : list->next))
+            {
+              GtkTreeViewColumn *column = list->data;
+              gtk_tree_view_column_cell_set_cell_data (column,
+                                                       tree_view->priv->model,
+                                                       &iter,
+                                                       GTK_RBNODE_FLAG_SET (node, GTK_RBNODE_IS_PARENT),
+                                                       node->children?TRUE:FALSE);
+            }
 
-      has_can_focus_cell = gtk_tree_view_has_can_focus_cell (tree_view);
+          has_can_focus_cell = gtk_tree_view_has_can_focus_cell (tree_view);
+        }
+      else
+        has_can_focus_cell = FALSE;
 
       for (list = (rtl ? g_list_last (tree_view->priv->columns) : g_list_first (tree_view->priv->columns));
 	   list;
@@ -7095,7 +7111,11 @@ do_presize_handler (GtkTreeView *tree_view)
 {
   if (tree_view->priv->mark_rows_col_dirty)
    {
-      if (tree_view->priv->tree)
+      /* In fixed height mode all columns have fixed sizing and rows
+       * never change height, so there is nothing to remeasure.
+       */
+      if (tree_view->priv->tree &&
+          !(tree_view->priv->fixed_height_mode && tree_view->priv->fixed_height >= 0))
 	_gtk_rbtree_column_invalid (tree_view->priv->tree);
       tree_view->priv->mark_rows_col_dirty = FALSE;
     }
@@ -7329,9 +7349,40 @@ _gtk_tree_view_install_mark_rows_col_dirty (GtkTreeView *tree_view,
     install_presize_handler (tree_view);
 }
 
+/* Measures rows spread evenly over the whole tree, so that an estimate
+ * of a column's width can be had without measuring every row.
+ */
+static void
+validate_row_sample (GtkTreeView *tree_view,
+                     guint        n_samples)
+{
+  GtkRBTree *tree;
+  GtkRBNode *node;
+  GtkTreePath *path;
+  GtkTreeIter iter;
+  guint n_rows, step, i;
+
+  n_rows = tree_view->priv->tree->root->total_count;
+  step = MAX (1, n_rows / n_samples);
+
+  for (i = 0; i < n_rows; i += step)
+    {
+      if (!_gtk_rbtree_find_index (tree_view->priv->tree, i, &tree, &node))
+        break;
+
+      path = _gtk_tree_path_new_from_rbtree (tree, node);
+      gtk_tree_model_get_iter (tree_view->priv->model, &iter, path);
+      validate_row (tree_view, tree, node, &iter, path);
+      gtk_tree_path_free (path);
+    }
+}
+
 /*
- * This function works synchronously (due to the while (validate_rows...)
- * loop).
+ * For models with up to GTK_TREE_VIEW_AUTOSIZE_SAMPLE_ROWS rows this
+ * function works synchronously (due to the while (validate_rows...)
+ * loop). For larger models only the visible rows and a sample of the
+ * others are measured right away, the remaining rows are measured in
+ * the background, growing the column as needed.
  *
  * There was a check for column_type != GTK_TREE_VIEW_COLUMN_AUTOSIZE
  * here. You now need to check that yourself.
@@ -7346,7 +7397,18 @@ _gtk_tree_view_column_autosize (GtkTreeView *tree_view,
   _gtk_tree_view_column_cell_set_dirty (column, FALSE);
 
   do_presize_handler (tree_view);
-  while (validate_rows (tree_view));
+
+  if (tree_view->priv->tree != NULL &&
+      gtk_widget_get_realized (GTK_WIDGET (tree_view)) &&
+      tree_view->priv->tree->root->total_count > GTK_TREE_VIEW_AUTOSIZE_SAMPLE_ROWS)
+    {
+      validate_row_sample (tree_view, GTK_TREE_VIEW_AUTOSIZE_SAMPLE_ROWS);
+      install_presize_handler (tree_view);
+    }
+  else
+    {
+      while (validate_rows (tree_view));
+    }
 
   gtk_widget_queue_resize (GTK_WIDGET (tree_view));
 }
@@ -9596,20 +9658,18 @@ gtk_tree_view_build_tree (GtkTreeView *tree_view,
 {
   GtkRBNode *temp = NULL;
   GtkTreePath *path = NULL;
+  gint height;
+
+  /* With a known fixed height, insert the rows valid and at their final
+   * height right away instead of walking up the tree twice per row to
+   * fix them up afterwards.
+   */
+  height = MAX (tree_view->priv->fixed_height, 0);
 
   do
     {
       gtk_tree_model_ref_node (tree_view->priv->model, iter);
-      temp = _gtk_rbtree_insert_after (tree, temp, 0, FALSE);
-
-      if (tree_view->priv->fixed_height > 0)
-        {
-          if (GTK_RBNODE_FLAG_SET (temp, GTK_RBNODE_INVALID))
-	    {
-              _gtk_rbtree_node_set_height (tree, temp, tree_view->priv->fixed_height);
-	      _gtk_rbtree_node_mark_valid (tree, temp);
-	    }
-        }
+      temp = _gtk_rbtree_insert_after (tree, temp, height, height > 0);
 
       if (tree_view->priv->is_list)
         continue;
@@ -28,6 +28,70 @@ test_set_source_big_pixbuf (void)
   cairo_surface_destroy (surface);
 }
 
+static void
+test_surface_from_pixbuf (void)
+{
+  guint size = g_test_perf () ? 1024 : 64;
+  cairo_surface_t *surface;
+  GdkPixbuf *pixbuf;
+  guchar *pixels, *data;
+  int rowstride, stride;
+  double elapsed;
+  guint x, y, i;
+
+  pixbuf = gdk_pixbuf_new (GDK_COLORSPACE_RGB, TRUE, 8, size, size);
+  pixels = gdk_pixbuf_get_pixels (pixbuf);
+  rowstride = gdk_pixbuf_get_rowstride (pixbuf);
+
+  /* Mix opaque, transparent and translucent pixels like icons have */
+  for (y = 0; y < size; y++)
+    for (x = 0; x < size; x++)
+      {
+        guchar *p = pixels + y * rowstride + x * 4;
+
+        p[0] = g_test_rand_int_range (0, 256);
+        p[1] = g_test_rand_int_range (0, 256);
+        p[2] = g_test_rand_int_range (0, 256);
+        switch (g_test_rand_int_range (0, 3))
+          {
+          case 0: p[3] = 0; break;
+          case 1: p[3] = 255; break;
+          default: p[3] = g_test_rand_int_range (0, 256); break;
+          }
+      }
+
+  g_test_timer_start ();
+
+  for (i = 0; i < 10; i++)
+    {
+      surface = gdk_cairo_surface_create_from_pixbuf (pixbuf, 1, NULL);
+      cairo_surface_destroy (surface);
+    }
+
+  elapsed = g_test_timer_elapsed ();
+  if (g_test_perf ())
+    g_test_minimized_result (elapsed / 10, "converting %ux%u pixbuf: %gsec", size, size, elapsed / 10);
+
+  surface = gdk_cairo_surface_create_from_pixbuf (pixbuf, 1, NULL);
+  data = cairo_image_surface_get_data (surface);
+  stride = cairo_image_surface_get_stride (surface);
+
+  for (y = 0; y < size; y++)
+    for (x = 0; x < size; x++)
+      {
+        guchar *p = pixels + y * rowstride + x * 4;
+        guint32 q = *(guint32 *) (data + y * stride + x * 4);
+
+        g_assert_cmpuint (q >> 24, ==, p[3]);
+        g_assert_cmpuint ((q >> 16) & 0xff, ==, (p[0] * p[3] + 127) / 255);
+        g_assert_cmpuint ((q >> 8) & 0xff, ==, (p[1] * p[3] + 127) / 255);
+        g_assert_cmpuint (q & 0xff, ==, (p[2] * p[3] + 127) / 255);
+      }
+
+  cairo_surface_destroy (surface);
+  g_object_unref (pixbuf);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -35,6 +99,7 @@ main (int argc, char *argv[])
   gdk_init (&argc, &argv);
 
   g_test_add_func ("/drawing/set-source-big-pixbuf", test_set_source_big_pixbuf);
+  g_test_add_func ("/drawing/surface-from-pixbuf", test_surface_from_pixbuf);
 
   return g_test_run ();
 }
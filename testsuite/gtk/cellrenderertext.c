@@ -0,0 +1,230 @@
+/* GtkCellRendererText tests.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtk/gtk.h>
+
+/* The renderer caches the widths it measured; every check measures
+ * twice so that both the measuring and the cached path are covered.
+ */
+static void
+get_width (GtkCellRenderer *cell,
+           GtkWidget       *widget,
+           gint            *minimum,
+           gint            *natural)
+{
+  gint min, nat;
+
+  gtk_cell_renderer_get_preferred_width (cell, widget, minimum, natural);
+  gtk_cell_renderer_get_preferred_width (cell, widget, &min, &nat);
+
+  g_assert_cmpint (min, ==, *minimum);
+  g_assert_cmpint (nat, ==, *natural);
+}
+
+static void
+test_width_text (void)
+{
+  GtkCellRenderer *cell;
+  GtkWidget *widget;
+  gint min, short_width, long_width;
+
+  widget = g_object_ref_sink (gtk_label_new (NULL));
+  cell = g_object_ref_sink (gtk_cell_renderer_text_new ());
+
+  g_object_set (cell, "text", "a", NULL);
+  get_width (cell, widget, &min, &short_width);
+
+  g_object_set (cell, "text", "aaaaaaaaaaaaaaaaaaaa", NULL);
+  get_width (cell, widget, &min, &long_width);
+  g_assert_cmpint (long_width, >, short_width);
+
+  g_object_set (cell, "text", "a", NULL);
+  get_width (cell, widget, &min, &long_width);
+  g_assert_cmpint (long_width, ==, short_width);
+
+  g_object_unref (cell);
+  g_object_unref (widget);
+}
+
+static void
+test_width_font (void)
+{
+  GtkCellRenderer *cell;
+  GtkWidget *widget;
+  gint min, small_width, large_width, width;
+
+  widget = g_object_ref_sink (gtk_label_new (NULL));
+  cell = g_object_ref_sink (gtk_cell_renderer_text_new ());
+
+  g_object_set (cell, "text", "aaaaaaaaaa", "font", "Sans 10", NULL);
+  get_width (cell, widget, &min, &small_width);
+
+  g_object_set (cell, "font", "Sans 30", NULL);
+  get_width (cell, widget, &min, &large_width);
+  g_assert_cmpint (large_width, >, small_width);
+
+  g_object_set (cell, "size-points", 10.0, NULL);
+  get_width (cell, widget, &min, &width);
+  g_assert_cmpint (width, ==, small_width);
+
+  g_object_set (cell, "scale", 3.0, NULL);
+  get_width (cell, widget, &min, &width);
+  g_assert_cmpint (width, >, small_width);
+
+  g_object_unref (cell);
+  g_object_unref (widget);
+}
+
+static void
+test_width_attributes (void)
+{
+  GtkCellRenderer *cell;
+  GtkWidget *widget;
+  PangoAttrList *attrs;
+  gint min, plain_width, width;
+
+  widget = g_object_ref_sink (gtk_label_new (NULL));
+  cell = g_object_ref_sink (gtk_cell_renderer_text_new ());
+
+  g_object_set (cell, "text", "aaaaaaaaaa", NULL);
+  get_width (cell, widget, &min, &plain_width);
+
+  attrs = pango_attr_list_new ();
+  pango_attr_list_insert (attrs, pango_attr_scale_new (3.0));
+  g_object_set (cell, "attributes", attrs, NULL);
+  pango_attr_list_unref (attrs);
+
+  get_width (cell, widget, &min, &width);
+  g_assert_cmpint (width, >, plain_width);
+
+  g_object_set (cell, "attributes", NULL, NULL);
+  get_width (cell, widget, &min, &width);
+  g_assert_cmpint (width, ==, plain_width);
+
+  g_object_unref (cell);
+  g_object_unref (widget);
+}
+
+static void
+test_width_markup (void)
+{
+  GtkCellRenderer *cell;
+  GtkWidget *widget;
+  gint min, plain_width, big_width, width;
+
+  widget = g_object_ref_sink (gtk_label_new (NULL));
+  cell = g_object_ref_sink (gtk_cell_renderer_text_new ());
+
+  g_object_set (cell, "markup", "aaaaaaaaaa", NULL);
+  get_width (cell, widget, &min, &plain_width);
+
+  g_object_set (cell, "markup", "<span size='xx-large'>aaaaaaaaaa</span>", NULL);
+  get_width (cell, widget, &min, &big_width);
+  g_assert_cmpint (big_width, >, plain_width);
+
+  /* Markup is part of the key, going back finds the earlier width */
+  g_object_set (cell, "markup", "aaaaaaaaaa", NULL);
+  get_width (cell, widget, &min, &width);
+  g_assert_cmpint (width, ==, plain_width);
+
+  /* Text with the same characters as markup is not the same thing */
+  g_object_set (cell, "text", "<span size='xx-large'>aaaaaaaaaa</span>", NULL);
+  get_width (cell, widget, &min, &width);
+  g_assert_cmpint (width, !=, big_width);
+
+  /* Attributes replacing those of the markup */
+  g_object_set (cell, "markup", "aaaaaaaaaa", NULL);
+  get_width (cell, widget, &min, &width);
+  g_object_set (cell, "attributes", NULL, NULL);
+  get_width (cell, widget, &min, &width);
+  g_assert_cmpint (width, ==, plain_width);
+
+  g_object_set (cell, "markup", "<span size='xx-large'>aaaaaaaaaa</span>", NULL);
+  g_object_set (cell, "attributes", NULL, NULL);
+  get_width (cell, widget, &min, &width);
+  g_assert_cmpint (width, ==, plain_width);
+
+  g_object_unref (cell);
+  g_object_unref (widget);
+}
+
+static void
+test_width_chars (void)
+{
+  GtkCellRenderer *cell;
+  GtkWidget *widget;
+  gint min, nat, text_min, text_nat;
+
+  widget = g_object_ref_sink (gtk_label_new (NULL));
+  cell = g_object_ref_sink (gtk_cell_renderer_text_new ());
+
+  g_object_set (cell, "text", "a", NULL);
+  get_width (cell, widget, &text_min, &text_nat);
+
+  g_object_set (cell, "width-chars", 40, NULL);
+  get_width (cell, widget, &min, &nat);
+  g_assert_cmpint (min, >, text_min);
+  g_assert_cmpint (nat, >, text_nat);
+
+  g_object_set (cell, "width-chars", -1, NULL);
+  get_width (cell, widget, &min, &nat);
+  g_assert_cmpint (min, ==, text_min);
+  g_assert_cmpint (nat, ==, text_nat);
+
+  g_object_unref (cell);
+  g_object_unref (widget);
+}
+
+static void
+test_width_ellipsize (void)
+{
+  GtkCellRenderer *cell;
+  GtkWidget *widget;
+  gint min, nat, text_min, text_nat;
+
+  widget = g_object_ref_sink (gtk_label_new (NULL));
+  cell = g_object_ref_sink (gtk_cell_renderer_text_new ());
+
+  g_object_set (cell, "text", "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaa", NULL);
+  get_width (cell, widget, &text_min, &text_nat);
+
+  g_object_set (cell, "ellipsize", PANGO_ELLIPSIZE_END, NULL);
+  get_width (cell, widget, &min, &nat);
+  g_assert_cmpint (min, <, text_min);
+  g_assert_cmpint (nat, ==, text_nat);
+
+  g_object_set (cell, "ellipsize", PANGO_ELLIPSIZE_NONE, NULL);
+  get_width (cell, widget, &min, &nat);
+  g_assert_cmpint (min, ==, text_min);
+
+  g_object_unref (cell);
+  g_object_unref (widget);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  g_test_add_func ("/cellrenderertext/width/text", test_width_text);
+  g_test_add_func ("/cellrenderertext/width/font", test_width_font);
+  g_test_add_func ("/cellrenderertext/width/attributes", test_width_attributes);
+  g_test_add_func ("/cellrenderertext/width/markup", test_width_markup);
+  g_test_add_func ("/cellrenderertext/width/width-chars", test_width_chars);
+  g_test_add_func ("/cellrenderertext/width/ellipsize", test_width_ellipsize);
+
+  return g_test_run ();
+}
@@ -5551,6 +5551,85 @@ specific_list_store_clear (void)
   gtk_list_store_clear (list);
 }
 
+static gboolean
+queue_refilter_visible_func (GtkTreeModel *model,
+                             GtkTreeIter  *iter,
+                             gpointer      data)
+{
+  gint *max_value = data;
+  gint value;
+
+  gtk_tree_model_get (model, iter, 0, &value, -1);
+
+  return value < *max_value;
+}
+
+static void
+specific_queue_refilter (void)
+{
+  GtkTreeIter iter, child;
+  GtkTreeStore *tree;
+  GtkTreeModel *filter;
+  GtkWidget *view;
+  gint max_value = 1000;
+  guint n_rows, i;
+
+  n_rows = g_test_perf () ? 100000 : 1000;
+
+  tree = gtk_tree_store_new (1, G_TYPE_INT);
+  for (i = 0; i < n_rows; i++)
+    {
+      gtk_tree_store_insert_with_values (tree, &iter, NULL, -1, 0, i, -1);
+      if (i % 10 == 0)
+        gtk_tree_store_insert_with_values (tree, &child, &iter, -1, 0, i, -1);
+    }
+
+  filter = gtk_tree_model_filter_new (GTK_TREE_MODEL (tree), NULL);
+  gtk_tree_model_filter_set_visible_func (GTK_TREE_MODEL_FILTER (filter),
+                                          queue_refilter_visible_func,
+                                          &max_value, NULL);
+  view = g_object_ref_sink (gtk_tree_view_new_with_model (filter));
+
+  g_assert_cmpint (gtk_tree_model_iter_n_children (filter, NULL), ==, MIN (n_rows, 1000));
+
+  max_value = 100;
+  gtk_tree_model_filter_queue_refilter (GTK_TREE_MODEL_FILTER (filter));
+
+  /* Nothing happens until the main loop runs */
+  g_assert_cmpint (gtk_tree_model_iter_n_children (filter, NULL), ==, MIN (n_rows, 1000));
+
+  /* Changes to the child model made before the refilter runs
+   * are picked up
+   */
+  gtk_tree_model_iter_nth_child (GTK_TREE_MODEL (tree), &iter, NULL, 0);
+  gtk_tree_store_remove (tree, &iter);
+
+  while (g_main_context_pending (NULL))
+    g_main_context_iteration (NULL, FALSE);
+
+  g_assert_cmpint (gtk_tree_model_iter_n_children (filter, NULL), ==, 99);
+  gtk_tree_model_iter_nth_child (filter, &iter, NULL, 9);
+  g_assert_cmpint (gtk_tree_model_iter_n_children (filter, &iter), ==, 1);
+
+  /* A synchronous refilter takes over a pending one */
+  max_value = 50;
+  gtk_tree_model_filter_queue_refilter (GTK_TREE_MODEL_FILTER (filter));
+  gtk_tree_model_filter_refilter (GTK_TREE_MODEL_FILTER (filter));
+  g_assert_cmpint (gtk_tree_model_iter_n_children (filter, NULL), ==, 49);
+
+  max_value = 20;
+  gtk_tree_model_filter_queue_refilter (GTK_TREE_MODEL_FILTER (filter));
+
+  /* Destroying the filter cancels a pending refilter */
+  gtk_widget_destroy (view);
+  g_object_unref (view);
+  g_object_unref (filter);
+  g_object_unref (tree);
+
+  while (g_main_context_pending (NULL))
+    g_main_context_iteration (NULL, FALSE);
+}
+
 static void
 specific_sort_ref_leaf_and_remove_ancestor (void)
 {
@@ -7175,6 +7254,8 @@ register_filter_model_tests (void)
                    specific_filter_add_child);
   g_test_add_func ("/TreeModelFilter/specific/list-store-clear",
                    specific_list_store_clear);
+  g_test_add_func ("/TreeModelFilter/specific/queue-refilter",
+                   specific_queue_refilter);
   g_test_add_func ("/TreeModelFilter/specific/sort-ref-leaf-and-remove-ancestor",
                    specific_sort_ref_leaf_and_remove_ancestor);
   g_test_add_func ("/TreeModelFilter/specific/ref-leaf-and-remove-ancestor",
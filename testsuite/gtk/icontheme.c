@@ -1,5 +1,6 @@
 #include <gtk/gtk.h>
 
+#include <glib/gstdio.h>
 #include <string.h>
 
 #define SCALABLE_IMAGE_SIZE (128)
@@ -524,6 +525,93 @@ test_svg_size (void)
   assert_icon_lookup_size ("twosize",  8, 0, "/icons/16x16s/twosize.svg", 12);
 }
 
+static void
+remove_directory (const gchar *path)
+{
+  const gchar *name;
+  GDir *dir;
+
+  dir = g_dir_open (path, 0, NULL);
+  if (dir == NULL)
+    return;
+
+  while ((name = g_dir_read_name (dir)) != NULL)
+    {
+      gchar *child = g_build_filename (path, name, NULL);
+
+      if (g_file_test (child, G_FILE_TEST_IS_DIR))
+        remove_directory (child);
+      else
+        g_remove (child);
+      g_free (child);
+    }
+
+  g_dir_close (dir);
+  g_rmdir (path);
+}
+
+static void
+test_rendered_cache (void)
+{
+  GtkIconInfo *info;
+  GdkPixbuf *first, *second;
+  GError *error = NULL;
+  gchar *cache_dir;
+  gchar *cache_file;
+  gchar *contents;
+  gsize length;
+  gsize pixels_length;
+  const guchar *pixels;
+  GDir *dir;
+  gsize i;
+
+  /* Start out empty, so that the one entry is the icon loaded here */
+  cache_dir = g_build_filename (g_get_user_cache_dir (), "gtk-3.0", "icons", NULL);
+  remove_directory (cache_dir);
+
+  info = gtk_icon_theme_lookup_icon (get_test_icontheme (TRUE), "twosize", 24, 0);
+  first = gtk_icon_info_load_icon (info, &error);
+  g_assert_no_error (error);
+  g_object_unref (info);
+
+  dir = g_dir_open (cache_dir, 0, &error);
+  g_assert_no_error (error);
+  cache_file = g_build_filename (cache_dir, g_dir_read_name (dir), NULL);
+  g_assert_null (g_dir_read_name (dir));
+  g_dir_close (dir);
+
+  /* The pixel data ends the file. Overwrite it, so that the icon can
+   * only have come from the cache if it comes back like that.
+   */
+  g_file_get_contents (cache_file, &contents, &length, &error);
+  g_assert_no_error (error);
+  pixels_length = gdk_pixbuf_get_byte_length (first);
+  g_assert_cmpuint (length, >, pixels_length);
+  memset (contents + length - pixels_length, 0x42, pixels_length);
+  g_file_set_contents (cache_file, contents, length, &error);
+  g_assert_no_error (error);
+  g_free (contents);
+
+  /* A fresh theme has nothing in memory, so this is read back from disk */
+  info = gtk_icon_theme_lookup_icon (get_test_icontheme (TRUE), "twosize", 24, 0);
+  second = gtk_icon_info_load_icon (info, &error);
+  g_assert_no_error (error);
+  g_object_unref (info);
+
+  g_assert_cmpint (gdk_pixbuf_get_width (first), ==, gdk_pixbuf_get_width (second));
+  g_assert_cmpint (gdk_pixbuf_get_height (first), ==, gdk_pixbuf_get_height (second));
+  g_assert_cmpint (gdk_pixbuf_get_rowstride (first), ==, gdk_pixbuf_get_rowstride (second));
+  g_assert_cmpint (gdk_pixbuf_get_has_alpha (first), ==, gdk_pixbuf_get_has_alpha (second));
+  pixels = gdk_pixbuf_get_pixels (second);
+  for (i = 0; i < pixels_length; i++)
+    g_assert_cmpint (pixels[i], ==, 0x42);
+
+  g_object_unref (first);
+  g_object_unref (second);
+  g_free (cache_file);
+  g_free (cache_dir);
+}
+
 static void
 test_builtin (void)
 {
@@ -786,6 +874,181 @@ test_nonsquare_symbolic (void)
   g_object_unref (info);
 }
 
+static void
+assert_symbolic_color (GdkPixbuf     *pixbuf,
+                       const GdkRGBA *color)
+{
+  guchar *pixels, *p;
+  gint x, y, stride;
+  gint n_opaque = 0;
+
+  g_assert_cmpint (gdk_pixbuf_get_n_channels (pixbuf), ==, 4);
+
+  pixels = gdk_pixbuf_get_pixels (pixbuf);
+  stride = gdk_pixbuf_get_rowstride (pixbuf);
+
+  for (y = 0; y < gdk_pixbuf_get_height (pixbuf); y++)
+    for (x = 0; x < gdk_pixbuf_get_width (pixbuf); x++)
+      {
+        p = pixels + y * stride + x * 4;
+        if (p[3] != 255)
+          continue;
+
+        g_assert_cmpint (p[0], ==, (guchar) (color->red * 255));
+        g_assert_cmpint (p[1], ==, (guchar) (color->green * 255));
+        g_assert_cmpint (p[2], ==, (guchar) (color->blue * 255));
+        n_opaque++;
+      }
+
+  g_assert_cmpint (n_opaque, >, 0);
+}
+
+static void
+test_symbolic_recolor (void)
+{
+  GtkIconInfo *info;
+  GFile *file;
+  GIcon *icon;
+  GdkPixbuf *pixbuf;
+  GdkRGBA red = { 1.0, 0.0, 0.0, 1.0 };
+  GdkRGBA blue = { 0.0, 0.0, 1.0, 1.0 };
+  gboolean was_symbolic = FALSE;
+  GError *error = NULL;
+  gchar *path = g_build_filename (g_test_get_dir (G_TEST_DIST),
+                                  "icons",
+                                  "scalable",
+                                  "nonsquare-symbolic.svg",
+                                  NULL);
+
+  file = g_file_new_for_path (path);
+  icon = g_file_icon_new (file);
+  info = gtk_icon_theme_lookup_by_gicon_for_scale (gtk_icon_theme_get_default (),
+                                                   icon, 36, 1, 0);
+  g_assert_nonnull (info);
+
+  /* The icon is rendered once and recolored for each set of colors */
+  pixbuf = gtk_icon_info_load_symbolic (info, &red, NULL, NULL, NULL,
+                                        &was_symbolic, &error);
+  g_assert_no_error (error);
+  g_assert_true (was_symbolic);
+  assert_symbolic_color (pixbuf, &red);
+  g_object_unref (pixbuf);
+
+  pixbuf = gtk_icon_info_load_symbolic (info, &blue, NULL, NULL, NULL,
+                                        &was_symbolic, &error);
+  g_assert_no_error (error);
+  g_assert_true (was_symbolic);
+  assert_symbolic_color (pixbuf, &blue);
+  g_object_unref (pixbuf);
+
+  g_object_unref (info);
+  g_object_unref (icon);
+  g_object_unref (file);
+  g_free (path);
+}
+
+static void
+assert_pixel_color (GdkPixbuf     *pixbuf,
+                    gint           x,
+                    gint           y,
+                    const GdkRGBA *color)
+{
+  guchar *p;
+
+  p = gdk_pixbuf_get_pixels (pixbuf) + y * gdk_pixbuf_get_rowstride (pixbuf) + x * 4;
+
+  g_assert_cmpint (p[3], ==, 255);
+  g_assert_cmpint (ABS (p[0] - (gint) (color->red * 255)), <=, 1);
+  g_assert_cmpint (ABS (p[1] - (gint) (color->green * 255)), <=, 1);
+  g_assert_cmpint (ABS (p[2] - (gint) (color->blue * 255)), <=, 1);
+}
+
+static void
+assert_symbolic_colors (GtkIconInfo   *info,
+                        const GdkRGBA *fg,
+                        const GdkRGBA *success,
+                        const GdkRGBA *warning,
+                        const GdkRGBA *error_color)
+{
+  GdkRGBA success_default = { 78 / 255., 154 / 255., 6 / 255., 1.0 };
+  GdkRGBA warning_default = { 245 / 255., 121 / 255., 62 / 255., 1.0 };
+  GdkRGBA error_default = { 204 / 255., 0, 0, 1.0 };
+  GdkPixbuf *pixbuf;
+  gboolean was_symbolic = FALSE;
+  GError *error = NULL;
+
+  pixbuf = gtk_icon_info_load_symbolic (info, fg, success, warning, error_color,
+                                        &was_symbolic, &error);
+
+  if (success == NULL)
+    success = &success_default;
+  if (warning == NULL)
+    warning = &warning_default;
+  if (error_color == NULL)
+    error_color = &error_default;
+
+  g_assert_no_error (error);
+  g_assert_true (was_symbolic);
+  g_assert_cmpint (gdk_pixbuf_get_width (pixbuf), ==, 32);
+  g_assert_cmpint (gdk_pixbuf_get_height (pixbuf), ==, 32);
+
+  /* One quadrant per color, see colors-symbolic.svg */
+  assert_pixel_color (pixbuf, 8, 8, fg);
+  assert_pixel_color (pixbuf, 24, 8, success);
+  assert_pixel_color (pixbuf, 8, 24, warning);
+  assert_pixel_color (pixbuf, 24, 24, error_color);
+
+  g_object_unref (pixbuf);
+}
+
+static void
+test_symbolic_recolor_classes (void)
+{
+  GtkIconInfo *info;
+  GFile *file;
+  GIcon *icon;
+  GdkRGBA red = { 1.0, 0.0, 0.0, 1.0 };
+  GdkRGBA green = { 0.0, 1.0, 0.0, 1.0 };
+  GdkRGBA blue = { 0.0, 0.0, 1.0, 1.0 };
+  GdkRGBA yellow = { 1.0, 1.0, 0.0, 1.0 };
+  GdkRGBA cyan = { 0.0, 1.0, 1.0, 1.0 };
+  GdkRGBA magenta = { 1.0, 0.0, 1.0, 1.0 };
+  gchar *path = g_build_filename (g_test_get_dir (G_TEST_DIST),
+                                  "icons",
+                                  "scalable",
+                                  "colors-symbolic.svg",
+                                  NULL);
+
+  file = g_file_new_for_path (path);
+  icon = g_file_icon_new (file);
+  info = gtk_icon_theme_lookup_by_gicon_for_scale (gtk_icon_theme_get_default (),
+                                                   icon, 32, 1, 0);
+  g_assert_nonnull (info);
+
+  /* The first colors are rendered directly, later ones are applied
+   * to the encoded icon; both have to put every color in its place.
+   */
+  assert_symbolic_colors (info, &red, &green, &blue, &yellow);
+  assert_symbolic_colors (info, &cyan, &magenta, &red, &green);
+  assert_symbolic_colors (info, &blue, &yellow, &cyan, &magenta);
+  assert_symbolic_colors (info, &red, &green, &blue, &yellow);
+
+  g_object_unref (info);
+
+  /* A new icon info finds the encoded icon in the rendered icon
+   * cache, check the default colors with that one.
+   */
+  info = gtk_icon_theme_lookup_by_gicon_for_scale (gtk_icon_theme_get_default (),
+                                                   icon, 32, 1, 0);
+  assert_symbolic_colors (info, &red, NULL, NULL, NULL);
+  assert_symbolic_colors (info, &blue, NULL, NULL, NULL);
+
+  g_object_unref (info);
+  g_object_unref (icon);
+  g_object_unref (file);
+  g_free (path);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -807,12 +1070,15 @@ main (int argc, char *argv[])
   g_test_add_func ("/icontheme/rtl", test_rtl);
   g_test_add_func ("/icontheme/symbolic-single-size", test_symbolic_single_size);
   g_test_add_func ("/icontheme/svg-size", test_svg_size);
+  g_test_add_func ("/icontheme/rendered-cache", test_rendered_cache);
   g_test_add_func ("/icontheme/size", test_size);
   g_test_add_func ("/icontheme/builtin", test_builtin);
   g_test_add_func ("/icontheme/list", test_list);
   g_test_add_func ("/icontheme/async", test_async);
   g_test_add_func ("/icontheme/inherit", test_inherit);
   g_test_add_func ("/icontheme/nonsquare-symbolic", test_nonsquare_symbolic);
+  g_test_add_func ("/icontheme/symbolic-recolor", test_symbolic_recolor);
+  g_test_add_func ("/icontheme/symbolic-recolor-classes", test_symbolic_recolor_classes);
 
   return g_test_run();
 }
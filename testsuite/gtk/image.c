@@ -0,0 +1,252 @@
+#include <gtk/gtk.h>
+#include <string.h>
+
+#define ICON_NAME "gtk-color-picker"
+#define ICON_SIZE 16
+
+/* The pixbuf that image helpers showing ICON_NAME at ICON_SIZE get
+ * from the icon theme; loading it also means they don't need to go
+ * to a thread for it.
+ */
+static GdkPixbuf *
+load_theme_pixbuf (void)
+{
+  GtkIconInfo *info;
+  GdkPixbuf *pixbuf;
+  GError *error = NULL;
+
+  info = gtk_icon_theme_lookup_icon (gtk_icon_theme_get_default (),
+                                     ICON_NAME, ICON_SIZE,
+                                     GTK_ICON_LOOKUP_USE_BUILTIN |
+                                     GTK_ICON_LOOKUP_FORCE_SIZE |
+                                     GTK_ICON_LOOKUP_DIR_LTR);
+  g_assert_nonnull (info);
+
+  pixbuf = gtk_icon_info_load_icon (info, &error);
+  g_assert_no_error (error);
+  g_object_unref (info);
+
+  return pixbuf;
+}
+
+static cairo_surface_t *
+get_shared_surface (GdkPixbuf *pixbuf)
+{
+  return g_object_get_qdata (G_OBJECT (pixbuf),
+                             g_quark_from_static_string ("gtk-icon-helper-shared-surface"));
+}
+
+static GtkWidget *
+add_image (GtkWidget *box)
+{
+  GtkWidget *image;
+
+  image = gtk_image_new_from_icon_name (ICON_NAME, GTK_ICON_SIZE_BUTTON);
+  gtk_image_set_pixel_size (GTK_IMAGE (image), ICON_SIZE);
+  gtk_container_add (GTK_CONTAINER (box), image);
+
+  return image;
+}
+
+static void
+test_shared_surface (void)
+{
+  GtkWidget *window, *box;
+  GtkWidget *image1, *image2;
+  GdkPixbuf *pixbuf;
+  cairo_surface_t *surface;
+
+  pixbuf = load_theme_pixbuf ();
+
+  window = gtk_offscreen_window_new ();
+  box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);
+  gtk_container_add (GTK_CONTAINER (window), box);
+  image1 = add_image (box);
+  image2 = add_image (box);
+
+  gtk_widget_show_all (window);
+  gtk_test_widget_wait_for_draw (window);
+
+  /* Both images draw from the one surface */
+  surface = get_shared_surface (pixbuf);
+  g_assert_nonnull (surface);
+  g_assert_cmpuint (cairo_surface_get_reference_count (surface), ==, 2);
+
+  gtk_widget_destroy (image1);
+  g_assert_true (get_shared_surface (pixbuf) == surface);
+  g_assert_cmpuint (cairo_surface_get_reference_count (surface), ==, 1);
+
+  /* It goes away with the last image using it */
+  gtk_widget_destroy (image2);
+  g_assert_null (get_shared_surface (pixbuf));
+
+  gtk_widget_destroy (window);
+  g_object_unref (pixbuf);
+}
+
+static void
+test_shared_surface_effect (void)
+{
+  GtkWidget *window, *box;
+  GtkWidget *image, *dimmed;
+  GtkCssProvider *provider;
+  GdkPixbuf *pixbuf;
+  cairo_surface_t *surface;
+  guchar *pixels;
+  gsize length;
+
+  pixbuf = load_theme_pixbuf ();
+  length = gdk_pixbuf_get_byte_length (pixbuf);
+  pixels = g_memdup (gdk_pixbuf_get_pixels (pixbuf), length);
+
+  provider = gtk_css_provider_new ();
+  gtk_css_provider_load_from_data (provider, "image.dimmed { -gtk-icon-effect: dim; }", -1, NULL);
+
+  window = gtk_offscreen_window_new ();
+  box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);
+  gtk_container_add (GTK_CONTAINER (window), box);
+  image = add_image (box);
+  dimmed = add_image (box);
+  gtk_style_context_add_provider (gtk_widget_get_style_context (dimmed),
+                                  GTK_STYLE_PROVIDER (provider),
+                                  GTK_STYLE_PROVIDER_PRIORITY_USER);
+  gtk_style_context_add_class (gtk_widget_get_style_context (dimmed), "dimmed");
+
+  gtk_widget_show_all (window);
+  gtk_test_widget_wait_for_draw (window);
+
+  /* The effect is applied to a copy of its own, the shared surface
+   * is only used by the other image and the icon is unchanged.
+   */
+  surface = get_shared_surface (pixbuf);
+  g_assert_nonnull (surface);
+  g_assert_cmpuint (cairo_surface_get_reference_count (surface), ==, 1);
+  g_assert (memcmp (gdk_pixbuf_get_pixels (pixbuf), pixels, length) == 0);
+
+  gtk_widget_destroy (image);
+  g_assert_null (get_shared_surface (pixbuf));
+
+  gtk_widget_destroy (window);
+  g_object_unref (provider);
+  g_object_unref (pixbuf);
+  g_free (pixels);
+}
+
+static guint32
+draw_pixel (GtkWidget *widget,
+            gint       x,
+            gint       y)
+{
+  cairo_surface_t *surface;
+  cairo_t *cr;
+  guint32 pixel;
+
+  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, ICON_SIZE, ICON_SIZE);
+  cr = cairo_create (surface);
+  gtk_widget_draw (widget, cr);
+  cairo_destroy (cr);
+
+  cairo_surface_flush (surface);
+  pixel = *(guint32 *) (cairo_image_surface_get_data (surface) +
+                        y * cairo_image_surface_get_stride (surface) +
+                        x * 4);
+  cairo_surface_destroy (surface);
+
+  return pixel;
+}
+
+/* A mapped image showing red that is switched to an icon that is not
+ * loaded yet, everything.svg, whose top right quarter is transparent.
+ */
+static GtkWidget *
+create_switched_image (GFile **file_out)
+{
+  GtkWidget *window, *image;
+  GdkPixbuf *pixbuf;
+  GFile *file;
+  GIcon *icon;
+  gchar *path;
+
+  pixbuf = gdk_pixbuf_new (GDK_COLORSPACE_RGB, TRUE, 8, ICON_SIZE, ICON_SIZE);
+  gdk_pixbuf_fill (pixbuf, 0xff0000ff);
+
+  window = gtk_offscreen_window_new ();
+  image = gtk_image_new_from_pixbuf (pixbuf);
+  gtk_image_set_pixel_size (GTK_IMAGE (image), ICON_SIZE);
+  gtk_container_add (GTK_CONTAINER (window), image);
+  g_object_unref (pixbuf);
+
+  gtk_widget_show_all (window);
+  gtk_test_widget_wait_for_draw (window);
+  g_assert_cmphex (draw_pixel (image, 12, 4), ==, 0xffff0000);
+
+  path = g_build_filename (g_test_get_dir (G_TEST_DIST),
+                           "icons", "scalable", "everything.svg",
+                           NULL);
+  file = g_file_new_for_path (path);
+  g_free (path);
+  icon = g_file_icon_new (file);
+  gtk_image_set_from_gicon (GTK_IMAGE (image), icon, GTK_ICON_SIZE_BUTTON);
+  g_object_unref (icon);
+
+  *file_out = file;
+
+  return image;
+}
+
+static void
+test_async_load (void)
+{
+  GtkWidget *image;
+  GFile *file;
+
+  image = create_switched_image (&file);
+
+  /* The icon is loaded in a thread; until it is there the image keeps
+   * showing what it showed before.
+   */
+  g_assert_cmphex (draw_pixel (image, 12, 4), ==, 0xffff0000);
+
+  while (draw_pixel (image, 12, 4) != 0)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_assert_cmphex (draw_pixel (image, 4, 4), ==, 0xff000000);
+
+  gtk_widget_destroy (gtk_widget_get_toplevel (image));
+  g_object_unref (file);
+}
+
+static void
+test_async_load_cancel (void)
+{
+  GtkWidget *image;
+  GFile *file;
+
+  image = create_switched_image (&file);
+
+  /* Start the load, then destroy the image while it is pending */
+  g_assert_cmphex (draw_pixel (image, 12, 4), ==, 0xffff0000);
+  gtk_widget_destroy (gtk_widget_get_toplevel (image));
+
+  /* The icon info loading the file holds on to it until the load
+   * finished and reported back, which must not touch the image.
+   */
+  g_object_add_weak_pointer (G_OBJECT (file), (gpointer *) &file);
+  g_object_unref (file);
+
+  while (file != NULL)
+    g_main_context_iteration (NULL, TRUE);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  g_test_add_func ("/image/shared-surface", test_shared_surface);
+  g_test_add_func ("/image/shared-surface-effect", test_shared_surface_effect);
+  g_test_add_func ("/image/async-load", test_async_load);
+  g_test_add_func ("/image/async-load-cancel", test_async_load_cancel);
+
+  return g_test_run ();
+}
@@ -0,0 +1,263 @@
+/* GtkLabel tests.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtk/gtk.h>
+
+#define WRAPPING_TEXT "A label with a text long enough that it needs to wrap " \
+                      "when the available width gets small"
+
+/* Labels remember the sizes they measured; every check measures twice
+ * so that both the measuring and the remembered result are covered.
+ */
+static gint
+get_height_for_width (GtkWidget *label,
+                      gint       width)
+{
+  gint min, nat, min2, nat2;
+
+  gtk_widget_get_preferred_height_for_width (label, width, &min, &nat);
+  gtk_widget_queue_resize (label);
+  gtk_widget_get_preferred_height_for_width (label, width, &min2, &nat2);
+
+  g_assert_cmpint (min, ==, min2);
+  g_assert_cmpint (nat, ==, nat2);
+
+  return nat;
+}
+
+static void
+get_width (GtkWidget *label,
+           gint      *minimum,
+           gint      *natural)
+{
+  gint min, nat;
+
+  gtk_widget_get_preferred_width (label, minimum, natural);
+  gtk_widget_queue_resize (label);
+  gtk_widget_get_preferred_width (label, &min, &nat);
+
+  g_assert_cmpint (min, ==, *minimum);
+  g_assert_cmpint (nat, ==, *natural);
+}
+
+static GtkWidget *
+create_wrapping_label (GtkWidget **window)
+{
+  GtkWidget *label;
+
+  *window = gtk_offscreen_window_new ();
+  label = gtk_label_new (WRAPPING_TEXT);
+  gtk_label_set_line_wrap (GTK_LABEL (label), TRUE);
+  gtk_container_add (GTK_CONTAINER (*window), label);
+  gtk_widget_show_all (*window);
+
+  return label;
+}
+
+static void
+test_size_cache_repeat (void)
+{
+  guint n = g_test_perf () ? 10000 : 100;
+  GtkWidget *box;
+  GtkWidget *label;
+  gint min, nat, min2, nat2;
+  double elapsed;
+  guint i;
+
+  box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+  g_object_ref_sink (box);
+
+  for (i = 0; i < n; i++)
+    {
+      label = gtk_label_new (WRAPPING_TEXT);
+      gtk_label_set_line_wrap (GTK_LABEL (label), TRUE);
+      gtk_container_add (GTK_CONTAINER (box), label);
+    }
+
+  gtk_widget_show_all (box);
+
+  g_test_timer_start ();
+
+  for (i = 0; i < 10; i++)
+    {
+      gtk_widget_queue_resize (box);
+      gtk_widget_get_preferred_height_for_width (box, 100 + 10 * (i % 2), &min, &nat);
+    }
+
+  elapsed = g_test_timer_elapsed ();
+  if (g_test_perf ())
+    g_test_minimized_result (elapsed, "measuring %u wrapping labels: %gsec", n, elapsed);
+
+  /* Heights depend on the width only */
+  gtk_widget_queue_resize (box);
+  gtk_widget_get_preferred_height_for_width (box, 100, &min2, &nat2);
+  gtk_widget_get_preferred_height_for_width (box, 110, &min, &nat);
+  gtk_widget_get_preferred_height_for_width (box, 100, &min, &nat);
+  g_assert_cmpint (min, ==, min2);
+  g_assert_cmpint (nat, ==, nat2);
+
+  g_object_unref (box);
+}
+
+static void
+test_size_cache_text (void)
+{
+  GtkWidget *window, *label;
+  gint height;
+
+  label = create_wrapping_label (&window);
+  height = get_height_for_width (label, 100);
+
+  gtk_label_set_text (GTK_LABEL (label), WRAPPING_TEXT " " WRAPPING_TEXT);
+  g_assert_cmpint (get_height_for_width (label, 100), >, height);
+
+  gtk_label_set_text (GTK_LABEL (label), WRAPPING_TEXT);
+  g_assert_cmpint (get_height_for_width (label, 100), ==, height);
+
+  gtk_widget_destroy (window);
+}
+
+static void
+test_size_cache_attributes (void)
+{
+  GtkWidget *window, *label;
+  PangoAttrList *attrs;
+  gint height;
+
+  label = create_wrapping_label (&window);
+  height = get_height_for_width (label, 100);
+
+  attrs = pango_attr_list_new ();
+  pango_attr_list_insert (attrs, pango_attr_scale_new (3.0));
+  gtk_label_set_attributes (GTK_LABEL (label), attrs);
+  pango_attr_list_unref (attrs);
+  g_assert_cmpint (get_height_for_width (label, 100), >, height);
+
+  gtk_label_set_attributes (GTK_LABEL (label), NULL);
+  g_assert_cmpint (get_height_for_width (label, 100), ==, height);
+
+  gtk_widget_destroy (window);
+}
+
+static void
+test_size_cache_wrap_mode (void)
+{
+  GtkWidget *window, *label;
+  gint min, width, height;
+
+  label = create_wrapping_label (&window);
+
+  /* Eight characters wide; whole words of five need a line each, but
+   * breaking between characters fits more than one word on a line.
+   */
+  gtk_label_set_line_wrap (GTK_LABEL (label), FALSE);
+  gtk_label_set_text (GTK_LABEL (label), "xxxxxxxx");
+  get_width (label, &min, &width);
+
+  gtk_label_set_line_wrap (GTK_LABEL (label), TRUE);
+  gtk_label_set_text (GTK_LABEL (label),
+                      "xxxxx xxxxx xxxxx xxxxx xxxxx xxxxx xxxxx xxxxx xxxxx xxxxx");
+  gtk_label_set_line_wrap_mode (GTK_LABEL (label), PANGO_WRAP_WORD);
+  height = get_height_for_width (label, width);
+
+  gtk_label_set_line_wrap_mode (GTK_LABEL (label), PANGO_WRAP_CHAR);
+  g_assert_cmpint (get_height_for_width (label, width), <, height);
+
+  gtk_label_set_line_wrap_mode (GTK_LABEL (label), PANGO_WRAP_WORD);
+  g_assert_cmpint (get_height_for_width (label, width), ==, height);
+
+  gtk_widget_destroy (window);
+}
+
+static void
+test_size_cache_width_chars (void)
+{
+  GtkWidget *window, *label;
+  gint min, nat, text_min, text_nat, height;
+
+  label = create_wrapping_label (&window);
+  get_width (label, &text_min, &text_nat);
+  gtk_widget_get_preferred_height (label, NULL, &height);
+
+  gtk_label_set_width_chars (GTK_LABEL (label), 60);
+  get_width (label, &min, &nat);
+  g_assert_cmpint (min, >, text_min);
+
+  gtk_label_set_width_chars (GTK_LABEL (label), -1);
+  get_width (label, &min, &nat);
+  g_assert_cmpint (min, ==, text_min);
+  g_assert_cmpint (nat, ==, text_nat);
+
+  /* The natural width is where the label wraps without a given width */
+  gtk_label_set_max_width_chars (GTK_LABEL (label), 10);
+  get_width (label, &min, &nat);
+  g_assert_cmpint (nat, <, text_nat);
+  gtk_widget_get_preferred_height (label, NULL, &nat);
+  g_assert_cmpint (nat, >, height);
+
+  gtk_label_set_max_width_chars (GTK_LABEL (label), -1);
+  get_width (label, &min, &nat);
+  g_assert_cmpint (nat, ==, text_nat);
+  gtk_widget_get_preferred_height (label, NULL, &nat);
+  g_assert_cmpint (nat, ==, height);
+
+  gtk_widget_destroy (window);
+}
+
+static void
+test_size_cache_font (void)
+{
+  GtkWidget *window, *label;
+  GtkCssProvider *provider;
+  GtkStyleContext *context;
+  gint height;
+
+  label = create_wrapping_label (&window);
+  gtk_test_widget_wait_for_draw (window);
+  height = get_height_for_width (label, 100);
+
+  provider = gtk_css_provider_new ();
+  gtk_css_provider_load_from_data (provider, "label.large { font-size: 30px; }", -1, NULL);
+  context = gtk_widget_get_style_context (label);
+  gtk_style_context_add_provider (context, GTK_STYLE_PROVIDER (provider),
+                                  GTK_STYLE_PROVIDER_PRIORITY_USER);
+  g_object_unref (provider);
+
+  gtk_style_context_add_class (context, "large");
+  gtk_test_widget_wait_for_draw (window);
+  g_assert_cmpint (get_height_for_width (label, 100), >, height);
+
+  gtk_style_context_remove_class (context, "large");
+  gtk_test_widget_wait_for_draw (window);
+  g_assert_cmpint (get_height_for_width (label, 100), ==, height);
+
+  gtk_widget_destroy (window);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv);
+
+  g_test_add_func ("/label/size-cache/repeat", test_size_cache_repeat);
+  g_test_add_func ("/label/size-cache/text", test_size_cache_text);
+  g_test_add_func ("/label/size-cache/attributes", test_size_cache_attributes);
+  g_test_add_func ("/label/size-cache/wrap-mode", test_size_cache_wrap_mode);
+  g_test_add_func ("/label/size-cache/width-chars", test_size_cache_width_chars);
+  g_test_add_func ("/label/size-cache/font", test_size_cache_font);
+
+  return g_test_run ();
+}
@@ -1,4 +1,5 @@
 #include <gtk/gtk.h>
+#include <string.h>
 
 static gint
 sort_list (GtkListBoxRow *row1,
@@ -434,6 +435,107 @@ test_header (void)
   g_object_unref (list);
 }
 
+#define N_DRAW_ROWS 20
+
+static gboolean
+count_draw (GtkWidget *widget,
+            cairo_t   *cr,
+            gpointer   data)
+{
+  (*(gint *) data)++;
+
+  return FALSE;
+}
+
+static void
+check_draw_clip (GtkWidget  *list,
+                 GtkWidget **rows,
+                 gint       *drawn,
+                 gint        y,
+                 gint        height)
+{
+  cairo_surface_t *surface;
+  cairo_t *cr;
+  gint i;
+
+  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                        gtk_widget_get_allocated_width (list),
+                                        gtk_widget_get_allocated_height (list));
+  cr = cairo_create (surface);
+  cairo_rectangle (cr, 0, y, gtk_widget_get_allocated_width (list), height);
+  cairo_clip (cr);
+
+  memset (drawn, 0, N_DRAW_ROWS * sizeof (gint));
+  gtk_widget_draw (list, cr);
+
+  /* Exactly the visible rows overlapping the clip get drawn */
+  for (i = 0; i < N_DRAW_ROWS; i++)
+    {
+      GtkAllocation alloc;
+      gboolean expected;
+
+      gtk_widget_get_allocation (rows[i], &alloc);
+      expected = gtk_widget_get_visible (rows[i]) &&
+                 alloc.y < y + height && alloc.y + alloc.height > y;
+
+      g_assert_cmpint (drawn[i], ==, expected ? 1 : 0);
+    }
+
+  cairo_destroy (cr);
+  cairo_surface_destroy (surface);
+}
+
+static void
+test_draw_clip (void)
+{
+  GtkWidget *window;
+  GtkWidget *list;
+  GtkWidget *rows[N_DRAW_ROWS];
+  gint drawn[N_DRAW_ROWS];
+  GtkAllocation alloc, last;
+  gint i;
+
+  window = gtk_offscreen_window_new ();
+  list = gtk_list_box_new ();
+  gtk_container_add (GTK_CONTAINER (window), list);
+
+  for (i = 0; i < N_DRAW_ROWS; i++)
+    {
+      rows[i] = gtk_list_box_row_new ();
+      gtk_widget_set_size_request (rows[i], 100, 20);
+      gtk_container_add (GTK_CONTAINER (list), rows[i]);
+      g_signal_connect (rows[i], "draw", G_CALLBACK (count_draw), &drawn[i]);
+    }
+
+  gtk_widget_show_all (window);
+  gtk_widget_hide (rows[0]);
+  gtk_widget_hide (rows[5]);
+  gtk_widget_hide (rows[6]);
+  gtk_widget_hide (rows[12]);
+  gtk_test_widget_wait_for_draw (window);
+
+  gtk_widget_get_allocation (rows[1], &alloc);
+  gtk_widget_get_allocation (rows[N_DRAW_ROWS - 1], &last);
+
+  /* the first visible row, fully and partially */
+  check_draw_clip (list, rows, drawn, 0, alloc.height);
+  check_draw_clip (list, rows, drawn, 0, alloc.height / 2);
+  /* partially visible rows on both ends */
+  check_draw_clip (list, rows, drawn, alloc.height / 2, 2 * alloc.height);
+  /* across the hidden rows in the middle */
+  gtk_widget_get_allocation (rows[4], &alloc);
+  check_draw_clip (list, rows, drawn, alloc.y + alloc.height / 2, 3 * alloc.height);
+  gtk_widget_get_allocation (rows[11], &alloc);
+  check_draw_clip (list, rows, drawn, alloc.y, alloc.height + 1);
+  /* the last row */
+  check_draw_clip (list, rows, drawn, last.y + last.height - 1, 1);
+  check_draw_clip (list, rows, drawn, last.y - 1, last.height + 1);
+  /* everything */
+  check_draw_clip (list, rows, drawn, 0, last.y + last.height);
+
+  gtk_widget_destroy (window);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -444,6 +546,7 @@ main (int argc, char *argv[])
   g_test_add_func ("/listbox/multi-selection", test_multi_selection);
   g_test_add_func ("/listbox/filter", test_filter);
   g_test_add_func ("/listbox/header", test_header);
+  g_test_add_func ("/listbox/draw-clip", test_draw_clip);
 
   return g_test_run ();
 }
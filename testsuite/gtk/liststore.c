@@ -472,6 +472,195 @@ list_store_set_gvalue_to_transform (void)
   gtk_list_store_set_value (store, &iter, 0, &value);
 }
 
+static void
+list_store_set_get_values (void)
+{
+  guint n = g_test_perf () ? 1000000 : 1000;
+  GtkListStore *store;
+  GtkTreeIter iter;
+  gchar *str, *expected;
+  gint i, value;
+  double elapsed;
+
+  store = gtk_list_store_new (4, G_TYPE_INT, G_TYPE_STRING, G_TYPE_DOUBLE, G_TYPE_STRING);
+
+  g_test_timer_start ();
+
+  for (i = 0; i < n; i++)
+    {
+      str = g_strdup_printf ("row %d", i);
+      /* leave column 1 unset */
+      gtk_list_store_insert_with_values (store, NULL, -1,
+                                         0, n - i,
+                                         3, str,
+                                         -1);
+      g_free (str);
+    }
+
+  elapsed = g_test_timer_elapsed ();
+  if (g_test_perf ())
+    g_test_minimized_result (elapsed, "populating list store with %u rows: %gsec", n, elapsed);
+
+  g_test_timer_start ();
+
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (store), 0, GTK_SORT_ASCENDING);
+
+  elapsed = g_test_timer_elapsed ();
+  if (g_test_perf ())
+    g_test_minimized_result (elapsed, "sorting list store with %u rows: %gsec", n, elapsed);
+
+  g_test_timer_start ();
+
+  i = 0;
+  g_assert (gtk_tree_model_get_iter_first (GTK_TREE_MODEL (store), &iter));
+  do
+    {
+      gtk_tree_model_get (GTK_TREE_MODEL (store), &iter, 0, &value, 1, &str, -1);
+      g_assert_cmpint (value, ==, ++i);
+      g_assert_null (str);
+
+      gtk_tree_model_get (GTK_TREE_MODEL (store), &iter, 3, &str, -1);
+      expected = g_strdup_printf ("row %d", n - i);
+      g_assert_cmpstr (str, ==, expected);
+      g_free (expected);
+      g_free (str);
+    }
+  while (gtk_tree_model_iter_next (GTK_TREE_MODEL (store), &iter));
+
+  g_assert_cmpint (i, ==, n);
+
+  elapsed = g_test_timer_elapsed ();
+  if (g_test_perf ())
+    g_test_minimized_result (elapsed, "reading list store with %u rows: %gsec", n, elapsed);
+
+  g_object_unref (store);
+}
+
+/* The test rows hold their position in column 0 */
+static void
+row_inserted_check_index (GtkTreeModel *model,
+                          GtkTreePath  *path,
+                          GtkTreeIter  *iter,
+                          gpointer      data)
+{
+  gint *n_inserted = data;
+  gint value;
+
+  gtk_tree_model_get (model, iter, 0, &value, -1);
+  g_assert_cmpint (gtk_tree_path_get_depth (path), ==, 1);
+  g_assert_cmpint (gtk_tree_path_get_indices (path)[0], ==, value);
+
+  (*n_inserted)++;
+}
+
+static void
+list_store_test_insert_rows (void)
+{
+  GtkListStore *store;
+  GtkTreeIter iter;
+  gint columns[] = { 0, 1 };
+  GValue values[6] = { G_VALUE_INIT, };
+  const gchar *expected[] = { "zero", "a", "b", "c", "last" };
+  gint n_inserted = 0;
+  gchar *str;
+  gint i, value;
+
+  for (i = 0; i < 3; i++)
+    {
+      g_value_init (&values[2 * i], G_TYPE_INT);
+      g_value_set_int (&values[2 * i], i + 1);
+      g_value_init (&values[2 * i + 1], G_TYPE_STRING);
+      g_value_set_string (&values[2 * i + 1], expected[i + 1]);
+    }
+
+  store = gtk_list_store_new (2, G_TYPE_INT, G_TYPE_STRING);
+  gtk_list_store_insert_with_values (store, NULL, -1, 0, 0, 1, "zero", -1);
+  gtk_list_store_insert_with_values (store, NULL, -1, 0, 4, 1, "last", -1);
+
+  g_signal_connect (store, "row-inserted", G_CALLBACK (row_inserted_check_index), &n_inserted);
+
+  gtk_list_store_insert_rows_with_valuesv (store, 1, 3, columns, values, 2);
+  g_assert_cmpint (n_inserted, ==, 3);
+
+  i = 0;
+  g_assert (gtk_tree_model_get_iter_first (GTK_TREE_MODEL (store), &iter));
+  do
+    {
+      gtk_tree_model_get (GTK_TREE_MODEL (store), &iter, 0, &value, 1, &str, -1);
+      g_assert_cmpint (value, ==, i);
+      g_assert_cmpstr (str, ==, expected[i]);
+      g_free (str);
+      i++;
+    }
+  while (gtk_tree_model_iter_next (GTK_TREE_MODEL (store), &iter));
+  g_assert_cmpint (i, ==, 5);
+
+  for (i = 0; i < 6; i++)
+    g_value_unset (&values[i]);
+
+  g_object_unref (store);
+}
+
+static void
+row_inserted_remove_first (GtkTreeModel *model,
+                           GtkTreePath  *path,
+                           GtkTreeIter  *iter,
+                           gpointer      data)
+{
+  GtkTreeIter first;
+
+  g_signal_handlers_disconnect_by_func (model, row_inserted_remove_first, data);
+
+  gtk_tree_model_get_iter_first (model, &first);
+  gtk_list_store_remove (GTK_LIST_STORE (model), &first);
+}
+
+static void
+list_store_test_insert_rows_reentrant (void)
+{
+  GtkListStore *store;
+  GtkTreeIter iter;
+  gint columns[] = { 0 };
+  GValue values[3] = { G_VALUE_INIT, G_VALUE_INIT, G_VALUE_INIT };
+  const gchar *expected[] = { "a", "last", "b", "c" };
+  gchar *str;
+  gint i;
+
+  for (i = 0; i < 3; i++)
+    {
+      g_value_init (&values[i], G_TYPE_STRING);
+      g_value_set_string (&values[i], expected[i == 0 ? 0 : i + 1]);
+    }
+
+  store = gtk_list_store_new (1, G_TYPE_STRING);
+  gtk_list_store_insert_with_values (store, NULL, -1, 0, "zero", -1);
+  gtk_list_store_insert_with_values (store, NULL, -1, 0, "last", -1);
+
+  /* Removing a row while the first new one is announced must not
+   * crash, the remaining rows go where single inserts would put them.
+   */
+  g_signal_connect (store, "row-inserted", G_CALLBACK (row_inserted_remove_first), NULL);
+
+  gtk_list_store_insert_rows_with_valuesv (store, 1, 3, columns, values, 1);
+
+  i = 0;
+  g_assert (gtk_tree_model_get_iter_first (GTK_TREE_MODEL (store), &iter));
+  do
+    {
+      gtk_tree_model_get (GTK_TREE_MODEL (store), &iter, 0, &str, -1);
+      g_assert_cmpstr (str, ==, expected[i]);
+      g_free (str);
+      i++;
+    }
+  while (gtk_tree_model_iter_next (GTK_TREE_MODEL (store), &iter));
+  g_assert_cmpint (i, ==, 4);
+
+  for (i = 0; i < 3; i++)
+    g_value_unset (&values[i]);
+
+  g_object_unref (store);
+}
+
 /* removal */
 static void
 list_store_test_remove_begin (ListStore     *fixture,
@@ -1037,6 +1226,12 @@ register_list_store_tests (void)
   /* setting values (FIXME) */
   g_test_add_func ("/ListStore/set-gvalue-to-transform",
                    list_store_set_gvalue_to_transform);
+  g_test_add_func ("/ListStore/set-get-values",
+                   list_store_set_get_values);
+  g_test_add_func ("/ListStore/insert-rows",
+                   list_store_test_insert_rows);
+  g_test_add_func ("/ListStore/insert-rows-reentrant",
+                   list_store_test_insert_rows_reentrant);
 
   /* removal */
   g_test_add ("/ListStore/remove-begin", ListStore, NULL,
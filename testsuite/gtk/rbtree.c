@@ -509,6 +509,175 @@ test_reorder (void)
   g_free (reorder);
 }
 
+static void
+test_insert_perf (void)
+{
+  guint n = g_test_perf () ? 1000000 : 100;
+  GtkRBTree *tree;
+  GtkRBNode *node;
+  guint i;
+  double elapsed;
+
+  tree = _gtk_rbtree_new ();
+
+  g_test_timer_start ();
+
+  node = NULL;
+  for (i = 0; i < n; i++)
+    node = _gtk_rbtree_insert_after (tree, node, i % 7 + 1, TRUE);
+
+  elapsed = g_test_timer_elapsed ();
+  if (g_test_perf ())
+    g_test_minimized_result (elapsed, "inserting %u items into rbtree: %gsec", n, elapsed);
+
+  _gtk_rbtree_test (tree);
+  g_assert_cmpint (tree->root->count, ==, n);
+
+  _gtk_rbtree_free (tree);
+}
+
+static void
+append_uniform_elements (GtkRBTree *tree,
+                         guint      depth,
+                         guint      elements_per_depth,
+                         gint       height)
+{
+  GtkRBNode *node;
+  guint i;
+
+  node = NULL;
+  for (i = 0; i < elements_per_depth; i++)
+    {
+      node = _gtk_rbtree_insert_after (tree, node, height, TRUE);
+      if (depth > 1)
+        {
+          node->children = _gtk_rbtree_new ();
+          node->children->parent_tree = tree;
+          node->children->parent_node = node;
+          append_uniform_elements (node->children, depth - 1, elements_per_depth, height);
+        }
+    }
+}
+
+static void
+test_find_offset (void)
+{
+  guint n_lookups = g_test_perf () ? 1000000 : 1000;
+  GtkRBTree *tree, *walk_tree, *found_tree;
+  GtkRBNode *node, *found_node;
+  gint total_height, cell_offset, offset;
+  guint i;
+  double elapsed;
+
+  tree = _gtk_rbtree_new ();
+  append_uniform_elements (tree, 3, g_test_perf () ? 100 : 10, 5);
+  _gtk_rbtree_test (tree);
+  total_height = tree->root->offset;
+
+  for (walk_tree = tree, node = _gtk_rbtree_first (tree), offset = 0;
+       node != NULL;
+       _gtk_rbtree_next_full (walk_tree, node, &walk_tree, &node))
+    {
+      g_assert_cmpint (_gtk_rbtree_node_find_offset (walk_tree, node), ==, offset);
+      cell_offset = _gtk_rbtree_find_offset (tree, offset + 2, &found_tree, &found_node);
+      g_assert (found_tree == walk_tree);
+      g_assert (found_node == node);
+      g_assert_cmpint (cell_offset, ==, 2);
+      offset += GTK_RBNODE_GET_HEIGHT (node);
+    }
+  g_assert_cmpint (offset, ==, total_height);
+
+  g_test_timer_start ();
+
+  for (i = 0, offset = 0; i < n_lookups; i++)
+    {
+      offset = (offset + 7919) % total_height;
+      cell_offset = _gtk_rbtree_find_offset (tree, offset, &found_tree, &found_node);
+      g_assert (found_node != NULL);
+      g_assert_cmpint (cell_offset, ==, offset % 5);
+    }
+
+  elapsed = g_test_timer_elapsed ();
+  if (g_test_perf ())
+    g_test_minimized_result (elapsed, "%u offset lookups in rbtree with %u items: %gsec",
+                             n_lookups, tree->root->total_count, elapsed);
+
+  _gtk_rbtree_free (tree);
+}
+
+static void
+test_fixed_height (void)
+{
+  GtkRBTree *tree, *walk_tree, *child_tree;
+  GtkRBNode *node;
+  guint n_rows;
+  double elapsed;
+
+  tree = _gtk_rbtree_new ();
+  append_uniform_elements (tree, 3, g_test_perf () ? 100 : 10, 1);
+  n_rows = tree->root->total_count;
+
+  g_test_timer_start ();
+
+  _gtk_rbtree_mark_invalid (tree);
+
+  elapsed = g_test_timer_elapsed ();
+  if (g_test_perf ())
+    g_test_minimized_result (elapsed, "marking rbtree with %u items invalid: %gsec",
+                             n_rows, elapsed);
+
+  _gtk_rbtree_test (tree);
+  g_assert (GTK_RBNODE_FLAG_SET (tree->root, GTK_RBNODE_DESCENDANTS_INVALID));
+
+  g_test_timer_start ();
+
+  _gtk_rbtree_set_fixed_height (tree, 10, TRUE);
+
+  elapsed = g_test_timer_elapsed ();
+  if (g_test_perf ())
+    g_test_minimized_result (elapsed, "setting fixed height on rbtree with %u items: %gsec",
+                             n_rows, elapsed);
+
+  _gtk_rbtree_test (tree);
+  g_assert (!GTK_RBNODE_FLAG_SET (tree->root, GTK_RBNODE_DESCENDANTS_INVALID));
+  g_assert_cmpint (tree->root->offset, ==, n_rows * 10);
+
+  for (walk_tree = tree, node = _gtk_rbtree_first (tree);
+       node != NULL;
+       _gtk_rbtree_next_full (walk_tree, node, &walk_tree, &node))
+    {
+      g_assert_cmpint (GTK_RBNODE_GET_HEIGHT (node), ==, 10);
+      g_assert (!GTK_RBNODE_FLAG_SET (node, GTK_RBNODE_INVALID));
+    }
+
+  /* Only invalid rows get the fixed height, and the change in size
+   * is propagated to the parent trees
+   */
+  child_tree = tree->root->children;
+  node = _gtk_rbtree_first (child_tree);
+  _gtk_rbtree_node_mark_invalid (child_tree, node);
+  _gtk_rbtree_set_fixed_height (child_tree, 20, FALSE);
+  _gtk_rbtree_test (tree);
+  g_assert_cmpint (GTK_RBNODE_GET_HEIGHT (node), ==, 20);
+  g_assert (GTK_RBNODE_FLAG_SET (node, GTK_RBNODE_INVALID));
+  g_assert (GTK_RBNODE_FLAG_SET (tree->root, GTK_RBNODE_DESCENDANTS_INVALID));
+  g_assert_cmpint (tree->root->offset, ==, (n_rows - 1) * 10 + 20);
+
+  _gtk_rbtree_set_fixed_height (tree, 30, TRUE);
+  _gtk_rbtree_test (tree);
+  g_assert_cmpint (GTK_RBNODE_GET_HEIGHT (node), ==, 30);
+  g_assert (!GTK_RBNODE_FLAG_SET (node, GTK_RBNODE_INVALID));
+  g_assert (!GTK_RBNODE_FLAG_SET (tree->root, GTK_RBNODE_DESCENDANTS_INVALID));
+  g_assert_cmpint (tree->root->offset, ==, (n_rows - 1) * 10 + 30);
+
+  _gtk_rbtree_column_invalid (tree);
+  _gtk_rbtree_test (tree);
+  g_assert (GTK_RBNODE_FLAG_SET (tree->root, GTK_RBNODE_COLUMN_INVALID));
+  g_assert (GTK_RBNODE_FLAG_SET (node, GTK_RBNODE_COLUMN_INVALID));
+
+  _gtk_rbtree_free (tree);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -522,6 +691,9 @@ main (int argc, char *argv[])
   g_test_add_func ("/rbtree/remove_node", test_remove_node);
   g_test_add_func ("/rbtree/remove_root", test_remove_root);
   g_test_add_func ("/rbtree/reorder", test_reorder);
+  g_test_add_func ("/rbtree/insert_perf", test_insert_perf);
+  g_test_add_func ("/rbtree/find_offset", test_find_offset);
+  g_test_add_func ("/rbtree/fixed_height", test_fixed_height);
 
   return g_test_run ();
 }
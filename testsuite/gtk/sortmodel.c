@@ -1029,6 +1029,103 @@ sorted_insert (void)
   g_object_unref (ref_model);
 }
 
+static void
+check_string_order (GtkTreeModel *model,
+                    GtkSortType   order)
+{
+  GtkTreeIter iter;
+  gchar *prev_str = NULL;
+  gint prev_index = -1;
+  gboolean valid;
+
+  valid = gtk_tree_model_get_iter_first (model, &iter);
+  while (valid)
+    {
+      gchar *str;
+      gint index;
+
+      gtk_tree_model_get (model, &iter, 0, &str, 1, &index, -1);
+
+      if (prev_index != -1)
+        {
+          gint cmp = g_utf8_collate (prev_str ? prev_str : "", str ? str : "");
+
+          if (order == GTK_SORT_DESCENDING)
+            cmp = -cmp;
+
+          g_assert_cmpint (cmp, <=, 0);
+          /* Rows with equal strings keep their relative order */
+          if (cmp == 0)
+            g_assert_cmpint (prev_index, <, index);
+        }
+
+      g_free (prev_str);
+      prev_str = str;
+      prev_index = index;
+
+      valid = gtk_tree_model_iter_next (model, &iter);
+    }
+
+  g_free (prev_str);
+}
+
+static void
+sort_strings (void)
+{
+  const gchar *words[] = { "banana", "Apple", "cherry", NULL, "apple",
+                           "\303\251clair", "date", "banana", "" };
+  GtkListStore *store;
+  GtkTreeModel *sort_model;
+  GtkTreeIter iter;
+  guint n_rows, i;
+  gdouble elapsed;
+
+  n_rows = g_test_perf () ? 200000 : 500;
+
+  store = gtk_list_store_new (2, G_TYPE_STRING, G_TYPE_INT);
+  for (i = 0; i < n_rows; i++)
+    {
+      gchar *str = NULL;
+
+      if (words[i % G_N_ELEMENTS (words)])
+        str = g_strdup_printf ("%s %u", words[i % G_N_ELEMENTS (words)],
+                               (i * 7919) % 97);
+      gtk_list_store_insert_with_values (store, &iter, -1, 0, str, 1, i, -1);
+      g_free (str);
+    }
+
+  sort_model = gtk_tree_model_sort_new_with_model (GTK_TREE_MODEL (store));
+
+  g_test_timer_start ();
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (sort_model),
+                                        0, GTK_SORT_ASCENDING);
+  elapsed = g_test_timer_elapsed ();
+  if (g_test_perf ())
+    g_test_minimized_result (elapsed, "sort model, %u rows: %gsec",
+                             n_rows, elapsed);
+  check_string_order (sort_model, GTK_SORT_ASCENDING);
+
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (sort_model),
+                                        0, GTK_SORT_DESCENDING);
+  check_string_order (sort_model, GTK_SORT_DESCENDING);
+
+  g_test_timer_start ();
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (store),
+                                        0, GTK_SORT_ASCENDING);
+  elapsed = g_test_timer_elapsed ();
+  if (g_test_perf ())
+    g_test_minimized_result (elapsed, "list store, %u rows: %gsec",
+                             n_rows, elapsed);
+  check_string_order (GTK_TREE_MODEL (store), GTK_SORT_ASCENDING);
+
+  gtk_tree_sortable_set_sort_column_id (GTK_TREE_SORTABLE (store),
+                                        0, GTK_SORT_DESCENDING);
+  check_string_order (GTK_TREE_MODEL (store), GTK_SORT_DESCENDING);
+
+  g_object_unref (sort_model);
+  g_object_unref (store);
+}
+
 
 static void
 specific_bug_300089 (void)
@@ -1318,6 +1415,9 @@ register_sort_model_tests (void)
   g_test_add_func ("/TreeModelSort/sorted-insert",
                    sorted_insert);
 
+  g_test_add_func ("/TreeModelSort/sort-strings",
+                   sort_strings);
+
   g_test_add_func ("/TreeModelSort/specific/bug-300089",
                    specific_bug_300089);
   g_test_add_func ("/TreeModelSort/specific/bug-364946",
@@ -1,4 +1,6 @@
 #include <gtk/gtk.h>
+#include <glib/gstdio.h>
+#include <string.h>
 
 typedef struct {
   GtkStyleContext *context;
@@ -577,6 +579,328 @@ test_style_priorities_three_context_higher (PrioritiesFixture *f,
   g_assert_true (gdk_rgba_equal (&ref_color, &color));
 }
 
+static GtkStyleContext *
+create_background_context (const char *declarations)
+{
+  GtkStyleContext *context;
+  GtkCssProvider *provider;
+  GtkWidgetPath *path;
+  char *css;
+
+  context = gtk_style_context_new ();
+  path = gtk_widget_path_new ();
+  gtk_widget_path_append_type (path, GTK_TYPE_BOX);
+  gtk_style_context_set_path (context, path);
+  gtk_widget_path_free (path);
+
+  css = g_strdup_printf ("* { %s }", declarations);
+  provider = gtk_css_provider_new ();
+  gtk_css_provider_load_from_data (provider, css, -1, NULL);
+  gtk_style_context_add_provider (context, GTK_STYLE_PROVIDER (provider),
+                                  GTK_STYLE_PROVIDER_PRIORITY_USER);
+  g_object_unref (provider);
+  g_free (css);
+
+  return context;
+}
+
+/* Draws the background of @context into a new image surface. Drawing
+ * to a recording surface first does without the renderings that
+ * gradients keep for image surfaces.
+ */
+static cairo_surface_t *
+render_background (GtkStyleContext *context,
+                   int              width,
+                   int              height,
+                   gboolean         cached)
+{
+  cairo_rectangle_t extents = { 0, 0, width, height };
+  cairo_surface_t *surface, *recording;
+  cairo_t *cr;
+
+  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, width, height);
+
+  if (cached)
+    {
+      cr = cairo_create (surface);
+      gtk_render_background (context, cr, 0, 0, width, height);
+      cairo_destroy (cr);
+    }
+  else
+    {
+      recording = cairo_recording_surface_create (CAIRO_CONTENT_COLOR_ALPHA, &extents);
+      cr = cairo_create (recording);
+      gtk_render_background (context, cr, 0, 0, width, height);
+      cairo_destroy (cr);
+
+      cr = cairo_create (surface);
+      cairo_set_source_surface (cr, recording, 0, 0);
+      cairo_set_operator (cr, CAIRO_OPERATOR_SOURCE);
+      cairo_paint (cr);
+      cairo_destroy (cr);
+      cairo_surface_destroy (recording);
+    }
+
+  cairo_surface_flush (surface);
+
+  return surface;
+}
+
+static void
+assert_cached_background (GtkStyleContext *context,
+                          int              width,
+                          int              height)
+{
+  cairo_surface_t *cached, *direct;
+  int stride, y;
+
+  cached = render_background (context, width, height, TRUE);
+  direct = render_background (context, width, height, FALSE);
+
+  stride = cairo_image_surface_get_stride (cached);
+  for (y = 0; y < height; y++)
+    g_assert (memcmp (cairo_image_surface_get_data (cached) + y * stride,
+                      cairo_image_surface_get_data (direct) + y * stride,
+                      width * 4) == 0);
+
+  cairo_surface_destroy (cached);
+  cairo_surface_destroy (direct);
+}
+
+static void
+test_gradient_cache (void)
+{
+  GtkStyleContext *context;
+
+  /* Vertical gradients keep a strip of their height, shared by all widths */
+  context = create_background_context ("background-image: linear-gradient(to bottom, red 5px, blue 50%, transparent);");
+  assert_cached_background (context, 100, 40);
+  assert_cached_background (context, 60, 40);
+  assert_cached_background (context, 20, 40);
+  assert_cached_background (context, 100, 64);
+  assert_cached_background (context, 100, 40);
+  g_object_unref (context);
+
+  context = create_background_context ("background-image: repeating-linear-gradient(90deg, red, blue 7px);");
+  assert_cached_background (context, 100, 50);
+  assert_cached_background (context, 60, 50);
+  assert_cached_background (context, 60, 20);
+  g_object_unref (context);
+
+  /* These depend on both dimensions and are kept whole */
+  context = create_background_context ("background-image: linear-gradient(45deg, red, blue);");
+  assert_cached_background (context, 50, 30);
+  assert_cached_background (context, 50, 30);
+  g_object_unref (context);
+
+  context = create_background_context ("background-image: radial-gradient(circle, red, blue 10px, green);");
+  assert_cached_background (context, 50, 30);
+  assert_cached_background (context, 30, 50);
+  assert_cached_background (context, 50, 30);
+  g_object_unref (context);
+}
+
+/* Draws @image scaled to @width x @height device pixels the way
+ * cairo does it when asked for a good filter.
+ */
+static cairo_surface_t *
+scale_image (cairo_surface_t *image,
+             int              width,
+             int              height)
+{
+  cairo_surface_t *surface;
+  cairo_t *cr;
+
+  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, width, height);
+  cr = cairo_create (surface);
+  cairo_scale (cr,
+               (double) width / cairo_image_surface_get_width (image),
+               (double) height / cairo_image_surface_get_height (image));
+  cairo_set_source_surface (cr, image, 0, 0);
+  cairo_pattern_set_filter (cairo_get_source (cr), CAIRO_FILTER_GOOD);
+  cairo_paint (cr);
+  cairo_destroy (cr);
+
+  cairo_surface_flush (surface);
+
+  return surface;
+}
+
+static void
+assert_scaled_background (GtkStyleContext *context,
+                          cairo_surface_t *image,
+                          int              size,
+                          int              scale)
+{
+  cairo_surface_t *surface, *expected;
+  guint32 *pixel;
+  cairo_t *cr;
+  int stride, y;
+
+  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, size * scale, size * scale);
+  cairo_surface_set_device_scale (surface, scale, scale);
+  cr = cairo_create (surface);
+  gtk_render_background (context, cr, 0, 0, size, size);
+  cairo_destroy (cr);
+  cairo_surface_flush (surface);
+
+  expected = scale_image (image, size * scale, size * scale);
+
+  stride = cairo_image_surface_get_stride (surface);
+  for (y = 0; y < size * scale; y++)
+    g_assert (memcmp (cairo_image_surface_get_data (surface) + y * stride,
+                      cairo_image_surface_get_data (expected) + y * stride,
+                      size * scale * 4) == 0);
+
+  /* The checkers are averaged to gray, not picked from */
+  pixel = (guint32 *) (cairo_image_surface_get_data (surface) + stride);
+  g_assert_cmphex (*pixel & 0xff, >=, 0x60);
+  g_assert_cmphex (*pixel & 0xff, <=, 0xa0);
+
+  cairo_surface_destroy (expected);
+  cairo_surface_destroy (surface);
+}
+
+static void
+test_image_scaling (void)
+{
+  GtkStyleContext *context;
+  cairo_surface_t *image;
+  guint32 *data;
+  char *dir, *filename, *uri, *css;
+  int stride, x, y;
+
+  /* Black and white checkers of one pixel */
+  image = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 64, 64);
+  data = (guint32 *) cairo_image_surface_get_data (image);
+  stride = cairo_image_surface_get_stride (image) / 4;
+  for (y = 0; y < 64; y++)
+    for (x = 0; x < 64; x++)
+      data[y * stride + x] = (x + y) % 2 ? 0xffffffff : 0xff000000;
+  cairo_surface_mark_dirty (image);
+
+  dir = g_dir_make_tmp ("stylecontext-XXXXXX", NULL);
+  g_assert_nonnull (dir);
+  filename = g_build_filename (dir, "checkers.png", NULL);
+  g_assert (cairo_surface_write_to_png (image, filename) == CAIRO_STATUS_SUCCESS);
+  uri = g_filename_to_uri (filename, NULL, NULL);
+
+  css = g_strdup_printf ("background-image: url(\"%s\");"
+                         "background-size: 100%% 100%%;"
+                         "background-repeat: no-repeat;",
+                         uri);
+  context = create_background_context (css);
+
+  /* Sizes are scaled once, in one step and kept; going back to an
+   * earlier size or scale must give the same pixels.
+   */
+  assert_scaled_background (context, image, 16, 1);
+  assert_scaled_background (context, image, 7, 1);
+  assert_scaled_background (context, image, 16, 2);
+  assert_scaled_background (context, image, 16, 1);
+  assert_scaled_background (context, image, 7, 1);
+
+  g_object_unref (context);
+  g_remove (filename);
+  g_rmdir (dir);
+  cairo_surface_destroy (image);
+  g_free (css);
+  g_free (uri);
+  g_free (filename);
+  g_free (dir);
+}
+
+/* Writes a plain 8x8 PNG of @color with a fixed modification time.
+ * Without compression, the file has the same size for every color.
+ */
+static void
+write_png (const char *filename,
+           guint32     color,
+           guint64     mtime,
+           guint32     mtime_usec)
+{
+  GdkPixbuf *pixbuf;
+  GFileInfo *info;
+  GFile *file;
+  GError *error = NULL;
+
+  pixbuf = gdk_pixbuf_new (GDK_COLORSPACE_RGB, FALSE, 8, 8, 8);
+  gdk_pixbuf_fill (pixbuf, color);
+  gdk_pixbuf_save (pixbuf, filename, "png", &error, "compression", "0", NULL);
+  g_assert_no_error (error);
+  g_object_unref (pixbuf);
+
+  info = g_file_info_new ();
+  g_file_info_set_attribute_uint64 (info, G_FILE_ATTRIBUTE_TIME_MODIFIED, mtime);
+  g_file_info_set_attribute_uint32 (info, G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC, mtime_usec);
+  file = g_file_new_for_path (filename);
+  g_file_set_attributes_from_info (file, info, G_FILE_QUERY_INFO_NONE, NULL, &error);
+  g_assert_no_error (error);
+  g_object_unref (file);
+  g_object_unref (info);
+}
+
+static guint32
+get_background_pixel (GtkStyleContext *context)
+{
+  cairo_surface_t *surface;
+  guint32 pixel;
+
+  surface = render_background (context, 8, 8, TRUE);
+  pixel = *(guint32 *) (cairo_image_surface_get_data (surface) +
+                        4 * cairo_image_surface_get_stride (surface) + 4 * 4);
+  cairo_surface_destroy (surface);
+
+  return pixel;
+}
+
+static void
+test_url_image_sharing (void)
+{
+  GtkStyleContext *first, *second;
+  char *dir, *filename, *uri, *css;
+  guint64 mtime;
+
+  dir = g_dir_make_tmp ("stylecontext-XXXXXX", NULL);
+  g_assert_nonnull (dir);
+  filename = g_build_filename (dir, "color.png", NULL);
+  uri = g_filename_to_uri (filename, NULL, NULL);
+  css = g_strdup_printf ("background-image: url(\"%s\");", uri);
+  mtime = g_get_real_time () / G_USEC_PER_SEC;
+
+  write_png (filename, 0xff0000ff, mtime, 0);
+  first = create_background_context (css);
+  g_assert_cmphex (get_background_pixel (first), ==, 0xffff0000);
+
+  /* Changing the pixels behind the cache's back shows that a second
+   * provider gets the image the first one decoded.
+   */
+  write_png (filename, 0x0000ffff, mtime, 0);
+  second = create_background_context (css);
+  g_assert_cmphex (get_background_pixel (second), ==, 0xffff0000);
+
+  /* Once both are gone, so is the image */
+  g_object_unref (first);
+  g_object_unref (second);
+  first = create_background_context (css);
+  g_assert_cmphex (get_background_pixel (first), ==, 0xff0000ff);
+
+  /* An edit within the same second is decoded again */
+  write_png (filename, 0x00ff00ff, mtime, 500000);
+  second = create_background_context (css);
+  g_assert_cmphex (get_background_pixel (second), ==, 0xff00ff00);
+  g_assert_cmphex (get_background_pixel (first), ==, 0xff0000ff);
+
+  g_object_unref (first);
+  g_object_unref (second);
+  g_remove (filename);
+  g_rmdir (dir);
+  g_free (css);
+  g_free (uri);
+  g_free (filename);
+  g_free (dir);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -590,6 +914,9 @@ main (int argc, char *argv[])
   g_test_add_func ("/style/invalidate-saved", test_invalidate_saved);
   g_test_add_func ("/style/widget-path-parent", test_widget_path_parent);
   g_test_add_func ("/style/classes", test_style_classes);
+  g_test_add_func ("/style/gradient-cache", test_gradient_cache);
+  g_test_add_func ("/style/image-scaling", test_image_scaling);
+  g_test_add_func ("/style/url-image-sharing", test_url_image_sharing);
 
 #define ADD_PRIORITIES_TEST(path, func) \
   g_test_add ("/style/priorities/" path, PrioritiesFixture, NULL, test_style_priorities_setup, \
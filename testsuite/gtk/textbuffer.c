@@ -1556,6 +1556,123 @@ test_get_iter (void)
   g_object_unref (buffer);
 }
 
+static void
+test_set_text_from_bytes (void)
+{
+  GtkTextBuffer *buffer;
+  GtkTextIter start, end;
+  GBytes *bytes;
+  const char data[] = "Hello\nWorld\303\251!";
+  char *text;
+
+  buffer = gtk_text_buffer_new (NULL);
+  gtk_text_buffer_set_text (buffer, "Previous contents", -1);
+
+  /* Leave out the trailing '!' to check that no nul terminator is needed */
+  bytes = g_bytes_new_static (data, strlen (data) - 1);
+  gtk_text_buffer_set_text_from_bytes (buffer, bytes);
+  g_bytes_unref (bytes);
+
+  g_assert_cmpint (gtk_text_buffer_get_line_count (buffer), ==, 2);
+  gtk_text_buffer_get_bounds (buffer, &start, &end);
+  text = gtk_text_buffer_get_text (buffer, &start, &end, TRUE);
+  g_assert_cmpstr (text, ==, "Hello\nWorld\303\251");
+  g_free (text);
+
+  bytes = g_bytes_new_static ("", 0);
+  gtk_text_buffer_set_text_from_bytes (buffer, bytes);
+  g_bytes_unref (bytes);
+
+  g_assert_cmpint (gtk_text_buffer_get_char_count (buffer), ==, 0);
+
+  g_object_unref (buffer);
+}
+
+static void
+test_serialize (void)
+{
+  guint n = g_test_perf () ? 100000 : 100;
+  GtkTextBuffer *buffer, *copy;
+  GtkTextTag *bold, *italic, *copy_bold;
+  GtkTextIter start, end, iter;
+  GdkAtom serialize_atom, deserialize_atom;
+  guint8 *data;
+  gsize length;
+  char *text, *copy_text;
+  GSList *tags;
+  GError *error = NULL;
+  double elapsed;
+  guint i;
+
+  buffer = gtk_text_buffer_new (NULL);
+  bold = gtk_text_buffer_create_tag (buffer, "bold", "weight", PANGO_WEIGHT_BOLD, NULL);
+  italic = gtk_text_buffer_create_tag (buffer, NULL, "style", PANGO_STYLE_ITALIC, NULL);
+
+  gtk_text_buffer_get_end_iter (buffer, &iter);
+  for (i = 0; i < n; i++)
+    {
+      gtk_text_buffer_insert (buffer, &iter, "plain <&> text, ", -1);
+      gtk_text_buffer_insert_with_tags (buffer, &iter, "bold text, ", -1, bold, NULL);
+      gtk_text_buffer_insert_with_tags (buffer, &iter, "both\n", -1, bold, italic, NULL);
+    }
+
+  serialize_atom = gtk_text_buffer_register_serialize_tagset (buffer, NULL);
+
+  gtk_text_buffer_get_bounds (buffer, &start, &end);
+
+  g_test_timer_start ();
+
+  data = gtk_text_buffer_serialize (buffer, buffer, serialize_atom,
+                                    &start, &end, &length);
+
+  elapsed = g_test_timer_elapsed ();
+  if (g_test_perf ())
+    g_test_minimized_result (elapsed, "serializing %" G_GSIZE_FORMAT " bytes: %gsec", length, elapsed);
+
+  copy = gtk_text_buffer_new (NULL);
+  deserialize_atom = gtk_text_buffer_register_deserialize_tagset (copy, NULL);
+  gtk_text_buffer_deserialize_set_can_create_tags (copy, deserialize_atom, TRUE);
+  gtk_text_buffer_get_start_iter (copy, &iter);
+
+  g_test_timer_start ();
+
+  gtk_text_buffer_deserialize (copy, copy, deserialize_atom, &iter,
+                               data, length, &error);
+
+  elapsed = g_test_timer_elapsed ();
+  if (g_test_perf ())
+    g_test_minimized_result (elapsed, "deserializing %" G_GSIZE_FORMAT " bytes: %gsec", length, elapsed);
+
+  g_assert_no_error (error);
+
+  text = gtk_text_buffer_get_text (buffer, &start, &end, TRUE);
+  gtk_text_buffer_get_bounds (copy, &start, &end);
+  copy_text = gtk_text_buffer_get_text (copy, &start, &end, TRUE);
+  g_assert_cmpstr (text, ==, copy_text);
+  g_free (text);
+  g_free (copy_text);
+
+  /* "both" carries the bold and the anonymous italic tag */
+  copy_bold = gtk_text_tag_table_lookup (gtk_text_buffer_get_tag_table (copy), "bold");
+  gtk_text_iter_forward_search (&start, "both", 0, &iter, NULL, NULL);
+  g_assert (gtk_text_iter_has_tag (&iter, copy_bold));
+  tags = gtk_text_iter_get_tags (&iter);
+  g_assert_cmpint (g_slist_length (tags), ==, 2);
+  g_slist_free (tags);
+
+  /* and bold runs on unbroken from "bold text, " into "both" */
+  g_assert (!gtk_text_iter_starts_tag (&iter, copy_bold));
+  gtk_text_iter_set_offset (&iter, 16);
+  g_assert (gtk_text_iter_starts_tag (&iter, copy_bold));
+  tags = gtk_text_iter_get_tags (&iter);
+  g_assert_cmpint (g_slist_length (tags), ==, 1);
+  g_slist_free (tags);
+
+  g_free (data);
+  g_object_unref (copy);
+  g_object_unref (buffer);
+}
+
 int
 main (int argc, char** argv)
 {
@@ -1575,6 +1692,8 @@ main (int argc, char** argv)
   g_test_add_func ("/TextBuffer/Tag", test_tag);
   g_test_add_func ("/TextBuffer/Clipboard", test_clipboard);
   g_test_add_func ("/TextBuffer/Get iter", test_get_iter);
+  g_test_add_func ("/TextBuffer/Set text from bytes", test_set_text_from_bytes);
+  g_test_add_func ("/TextBuffer/Serialize", test_serialize);
 
   return g_test_run();
 }
@@ -194,6 +194,28 @@ test_search (void)
   check_found_backward ("aa \303\200", "aa", 0, 0, 2, "aa");
 }
 
+static void
+test_search_long_buffer (void)
+{
+  GString *haystack;
+  int i, offset;
+
+  /* enough lines for the search to span several blocks */
+  haystack = g_string_new (NULL);
+  for (i = 0; i < 5000; i++)
+    g_string_append (haystack, "some text without a match\n");
+  offset = g_utf8_strlen (haystack->str, -1);
+
+  g_string_append (haystack, "foo\nbar\n");
+
+  check_found_forward (haystack->str, "foo", 0, offset, offset + 3, "foo");
+  check_found_forward (haystack->str, "foo\nbar", 0, offset, offset + 7, "foo\nbar");
+  check_found_forward (haystack->str, "match\nfoo", 0, offset - 6, offset + 3, "match\nfoo");
+  check_not_found (haystack->str, "foo\nfoo", 0);
+
+  g_string_free (haystack, TRUE);
+}
+
 static void
 test_search_caseless (void)
 {
@@ -788,6 +810,7 @@ main (int argc, char** argv)
   g_test_add_func ("/TextIter/Search Empty", test_empty_search);
   g_test_add_func ("/TextIter/Search Full Buffer", test_search_full_buffer);
   g_test_add_func ("/TextIter/Search", test_search);
+  g_test_add_func ("/TextIter/Search Long Buffer", test_search_long_buffer);
   g_test_add_func ("/TextIter/Search Caseless", test_search_caseless);
   g_test_add_func ("/TextIter/Forward To Tag Toggle", test_forward_to_tag_toggle);
   g_test_add_func ("/TextIter/Forward To Line End", test_forward_to_line_end);
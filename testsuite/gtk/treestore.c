@@ -475,6 +475,132 @@ tree_store_set_gvalue_to_transform (void)
   gtk_tree_store_set_value (store, &iter, 0, &value);
 }
 
+/* All test rows are inserted below the first toplevel row */
+static void
+row_inserted_check_parent (GtkTreeModel *model,
+                           GtkTreePath  *path,
+                           GtkTreeIter  *iter,
+                           gpointer      data)
+{
+  GtkTreeIter parent, first;
+  gint *n_inserted = data;
+
+  g_assert_cmpint (gtk_tree_path_get_depth (path), ==, 2);
+  g_assert (gtk_tree_model_iter_parent (model, &parent, iter));
+  g_assert (gtk_tree_model_get_iter_first (model, &first));
+  g_assert (parent.user_data == first.user_data);
+
+  (*n_inserted)++;
+}
+
+static void
+count_signal (GtkTreeModel *model,
+              GtkTreePath  *path,
+              GtkTreeIter  *iter,
+              gpointer      data)
+{
+  (*(gint *) data)++;
+}
+
+static void
+tree_store_test_insert_rows (void)
+{
+  GtkTreeStore *store;
+  GtkTreeIter parent, iter;
+  gint columns[] = { 0 };
+  GValue values[3] = { G_VALUE_INIT, G_VALUE_INIT, G_VALUE_INIT };
+  gint n_inserted = 0, n_toggled = 0;
+  gint i, value;
+
+  for (i = 0; i < 3; i++)
+    {
+      g_value_init (&values[i], G_TYPE_INT);
+      g_value_set_int (&values[i], i + 1);
+    }
+
+  store = gtk_tree_store_new (1, G_TYPE_INT);
+  gtk_tree_store_insert_with_values (store, &parent, NULL, -1, 0, 0, -1);
+
+  g_signal_connect (store, "row-inserted", G_CALLBACK (row_inserted_check_parent), &n_inserted);
+  g_signal_connect (store, "row-has-child-toggled", G_CALLBACK (count_signal), &n_toggled);
+
+  gtk_tree_store_insert_rows_with_valuesv (store, &parent, -1, 2, columns, values, 1);
+  g_assert_cmpint (n_inserted, ==, 2);
+  g_assert_cmpint (n_toggled, ==, 1);
+
+  /* insert in between the existing children */
+  gtk_tree_store_insert_rows_with_valuesv (store, &parent, 1, 1, columns, &values[2], 1);
+  g_assert_cmpint (n_inserted, ==, 3);
+  g_assert_cmpint (n_toggled, ==, 1);
+
+  g_assert_cmpint (gtk_tree_model_iter_n_children (GTK_TREE_MODEL (store), &parent), ==, 3);
+  g_assert (gtk_tree_model_iter_children (GTK_TREE_MODEL (store), &iter, &parent));
+  gtk_tree_model_get (GTK_TREE_MODEL (store), &iter, 0, &value, -1);
+  g_assert_cmpint (value, ==, 1);
+  g_assert (gtk_tree_model_iter_next (GTK_TREE_MODEL (store), &iter));
+  gtk_tree_model_get (GTK_TREE_MODEL (store), &iter, 0, &value, -1);
+  g_assert_cmpint (value, ==, 3);
+  g_assert (gtk_tree_model_iter_next (GTK_TREE_MODEL (store), &iter));
+  gtk_tree_model_get (GTK_TREE_MODEL (store), &iter, 0, &value, -1);
+  g_assert_cmpint (value, ==, 2);
+
+  for (i = 0; i < 3; i++)
+    g_value_unset (&values[i]);
+
+  g_object_unref (store);
+}
+
+static void
+row_inserted_remove_sibling (GtkTreeModel *model,
+                             GtkTreePath  *path,
+                             GtkTreeIter  *iter,
+                             gpointer      data)
+{
+  g_signal_handlers_disconnect_by_func (model, row_inserted_remove_sibling, data);
+
+  /* This is the row the next new rows would be inserted after */
+  gtk_tree_store_remove (GTK_TREE_STORE (model), iter);
+}
+
+static void
+tree_store_test_insert_rows_reentrant (void)
+{
+  GtkTreeStore *store;
+  GtkTreeIter parent, iter;
+  gint columns[] = { 0 };
+  GValue values[3] = { G_VALUE_INIT, G_VALUE_INIT, G_VALUE_INIT };
+  gint expected[] = { 0, 2, 3 };
+  gint i, value;
+
+  for (i = 0; i < 3; i++)
+    {
+      g_value_init (&values[i], G_TYPE_INT);
+      g_value_set_int (&values[i], i + 1);
+    }
+
+  store = gtk_tree_store_new (1, G_TYPE_INT);
+  gtk_tree_store_insert_with_values (store, &parent, NULL, -1, 0, -1, -1);
+  gtk_tree_store_insert_with_values (store, NULL, &parent, -1, 0, 0, -1);
+
+  g_signal_connect (store, "row-inserted", G_CALLBACK (row_inserted_remove_sibling), NULL);
+
+  gtk_tree_store_insert_rows_with_valuesv (store, &parent, 1, 3, columns, values, 1);
+
+  g_assert_cmpint (gtk_tree_model_iter_n_children (GTK_TREE_MODEL (store), &parent), ==, 3);
+  g_assert (gtk_tree_model_iter_children (GTK_TREE_MODEL (store), &iter, &parent));
+  for (i = 0; i < 3; i++)
+    {
+      gtk_tree_model_get (GTK_TREE_MODEL (store), &iter, 0, &value, -1);
+      g_assert_cmpint (value, ==, expected[i]);
+      gtk_tree_model_iter_next (GTK_TREE_MODEL (store), &iter);
+    }
+
+  for (i = 0; i < 3; i++)
+    g_value_unset (&values[i]);
+
+  g_object_unref (store);
+}
+
 /* removal */
 static void
 tree_store_test_remove_begin (TreeStore     *fixture,
@@ -1095,6 +1221,10 @@ register_tree_store_tests (void)
   /* setting values (FIXME) */
   g_test_add_func ("/TreeStore/set-gvalue-to-transform",
                    tree_store_set_gvalue_to_transform);
+  g_test_add_func ("/TreeStore/insert-rows",
+                   tree_store_test_insert_rows);
+  g_test_add_func ("/TreeStore/insert-rows-reentrant",
+                   tree_store_test_insert_rows_reentrant);
 
   /* removal */
   g_test_add ("/TreeStore/remove-begin", TreeStore, NULL,
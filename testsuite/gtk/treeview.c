@@ -237,6 +237,151 @@ test_row_separator_height (void)
   gtk_widget_destroy (tree_view);
 }
 
+static void
+test_fixed_height_expand (void)
+{
+  GtkTreeViewColumn *column;
+  GtkTreeIter parent;
+  GtkTreePath *path;
+  GtkTreeStore *store;
+  GtkWidget *window;
+  GtkWidget *tree_view;
+  GdkRectangle rect = { 0, };
+  gint columns[] = { 0 };
+  GValue *values;
+  gint row_height;
+  guint n_children, i;
+  gdouble elapsed;
+
+  n_children = g_test_perf () ? 1000000 : 1000;
+
+  store = gtk_tree_store_new (1, G_TYPE_STRING);
+  gtk_tree_store_insert_with_values (store, &parent, NULL, 0, 0, "Parent", -1);
+
+  /* Inserting the children one by one walks the siblings each time */
+  values = g_new0 (GValue, n_children);
+  for (i = 0; i < n_children; i++)
+    {
+      g_value_init (&values[i], G_TYPE_STRING);
+      g_value_set_static_string (&values[i], "Child");
+    }
+  gtk_tree_store_insert_rows_with_valuesv (store, &parent, -1, n_children,
+                                           columns, values, 1);
+  for (i = 0; i < n_children; i++)
+    g_value_unset (&values[i]);
+  g_free (values);
+
+  window = gtk_offscreen_window_new ();
+
+  tree_view = gtk_tree_view_new_with_model (GTK_TREE_MODEL (store));
+  column = gtk_tree_view_column_new_with_attributes ("Test",
+                                                     gtk_cell_renderer_text_new (),
+                                                     "text", 0,
+                                                     NULL);
+  gtk_tree_view_column_set_sizing (column, GTK_TREE_VIEW_COLUMN_FIXED);
+  gtk_tree_view_column_set_fixed_width (column, 100);
+  gtk_tree_view_append_column (GTK_TREE_VIEW (tree_view), column);
+  gtk_tree_view_set_fixed_height_mode (GTK_TREE_VIEW (tree_view), TRUE);
+
+  gtk_container_add (GTK_CONTAINER (window), tree_view);
+  gtk_widget_show_all (window);
+
+  gtk_test_widget_wait_for_draw (window);
+
+  path = gtk_tree_path_new_from_indices (0, -1);
+  gtk_tree_view_get_background_area (GTK_TREE_VIEW (tree_view),
+                                     path, NULL, &rect);
+  row_height = rect.height;
+  g_assert_cmpint (row_height, >, 0);
+
+  g_test_timer_start ();
+  gtk_tree_view_expand_row (GTK_TREE_VIEW (tree_view), path, FALSE);
+  elapsed = g_test_timer_elapsed ();
+  if (g_test_perf ())
+    g_test_minimized_result (elapsed, "expanding %u rows in fixed height mode: %gsec",
+                             n_children, elapsed);
+  gtk_tree_path_free (path);
+
+  /* All new rows got the fixed height without being measured */
+  path = gtk_tree_path_new_from_indices (0, n_children - 1, -1);
+  gtk_tree_view_get_background_area (GTK_TREE_VIEW (tree_view),
+                                     path, NULL, &rect);
+  gtk_tree_path_free (path);
+
+  g_assert_cmpint (rect.height, ==, row_height);
+  g_assert_cmpint (rect.y, ==, n_children * row_height);
+
+  gtk_widget_destroy (window);
+  g_object_unref (store);
+}
+
+static void
+test_autosize_sample (void)
+{
+  GtkTreeViewColumn *column;
+  GtkListStore *store;
+  GtkWidget *window;
+  GtkWidget *sw;
+  GtkWidget *tree_view;
+  gint full_width, sample_width;
+  gchar *wide;
+  guint i;
+
+  /* Many more rows than GTK_TREE_VIEW_AUTOSIZE_SAMPLE_ROWS, so that
+   * autosizing samples every 30th row; the wide row is not one of them.
+   * It is near the end, so that measuring rows from the top for a while
+   * doesn't get to it either.
+   */
+  store = gtk_list_store_new (1, G_TYPE_STRING);
+  for (i = 0; i < 30000; i++)
+    gtk_list_store_insert_with_values (store, NULL, -1, 0, "x", -1);
+
+  wide = g_strnfill (200, 'W');
+  gtk_list_store_insert_with_values (store, NULL, 29998, 0, wide, -1);
+  g_free (wide);
+
+  window = gtk_offscreen_window_new ();
+  sw = gtk_scrolled_window_new (NULL, NULL);
+  gtk_widget_set_size_request (sw, 200, 200);
+  gtk_container_add (GTK_CONTAINER (window), sw);
+
+  tree_view = gtk_tree_view_new_with_model (GTK_TREE_MODEL (store));
+  column = gtk_tree_view_column_new_with_attributes ("Test",
+                                                     gtk_cell_renderer_text_new (),
+                                                     "text", 0,
+                                                     NULL);
+  gtk_tree_view_column_set_sizing (column, GTK_TREE_VIEW_COLUMN_AUTOSIZE);
+  gtk_tree_view_append_column (GTK_TREE_VIEW (tree_view), column);
+  gtk_container_add (GTK_CONTAINER (sw), tree_view);
+  gtk_widget_show_all (window);
+
+  while (gtk_events_pending ())
+    gtk_main_iteration ();
+  gtk_test_widget_wait_for_draw (window);
+
+  full_width = gtk_tree_view_column_get_width (column);
+  g_assert_cmpint (full_width, >, 200);
+
+  /* Autosizes the column again, measuring only the sample right away,
+   * so the width the tree view asks for leaves out the wide row.
+   */
+  gtk_tree_view_column_set_min_width (column, 10);
+  gtk_widget_get_preferred_width (tree_view, &sample_width, NULL);
+  g_assert_cmpint (sample_width, <, full_width);
+
+  /* Once the remaining rows have been measured in the background the
+   * wide row is accounted for again.
+   */
+  while (gtk_events_pending ())
+    gtk_main_iteration ();
+  gtk_test_widget_wait_for_draw (window);
+
+  g_assert_cmpint (gtk_tree_view_column_get_width (column), ==, full_width);
+
+  gtk_widget_destroy (window);
+  g_object_unref (store);
+}
+
 static void
 test_selection_count (void)
 {
@@ -357,6 +502,10 @@ main (int    argc,
                    test_select_collapsed_row);
   g_test_add_func ("/TreeView/sizing/row-separator-height",
                    test_row_separator_height);
+  g_test_add_func ("/TreeView/sizing/fixed-height-expand",
+                   test_fixed_height_expand);
+  g_test_add_func ("/TreeView/sizing/autosize-sample",
+                   test_autosize_sample);
   g_test_add_func ("/TreeView/selection/count", test_selection_count);
   g_test_add_func ("/TreeView/selection/empty", test_selection_empty);
 